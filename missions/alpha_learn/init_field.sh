@@ -138,10 +138,16 @@ if [ "$SHIFT_X" != "0" ] || [ "$SHIFT_Y" != "0" ]; then
     SWIM_REGION=$(shift_swim_region "$SWIM_REGION" "$SHIFT_X" "$SHIFT_Y")
 fi
 
-# generate randomly placed swimmers
+# generate randomly placed swimmers, with gen_swim_file (built from
+# src/general_utils) when it is on the path
 if [ "${RAND_SWIMMERS}" != "" ]; then
-    gen_swimmers --poly=$SWIM_REGION --swimmers=$SWIMMERS   \
-                 --unreg=$UNREGERS --sep=7 > $SWIM_FILE
+    if command -v gen_swim_file > /dev/null; then
+        gen_swim_file --poly=$SWIM_REGION --swimmers=$SWIMMERS  \
+                      --unreg=$UNREGERS --sep=7 > $SWIM_FILE
+    else
+        gen_swimmers --poly=$SWIM_REGION --swimmers=$SWIMMERS   \
+                     --unreg=$UNREGERS --sep=7 > $SWIM_FILE
+    fi
 fi
 
 # Set the speeds and names
@@ -30,6 +30,8 @@ MMOD=""
 XLAUNCHED="no"
 NOGUI=""
 AUTODEPLOY="no"
+LOCKSTEP="no"
+LOCKSTEP_VNAMES=""
 LAUNCH_UMAYFINISH="no"
 MAXDBUPTIME=600
 
@@ -100,6 +102,8 @@ for ARGI; do
 	echo "  --nogui, -ng       Headless launch, no gui   "
     echo "  --autodeploy       Automatically deploy      "
     echo "                     vehicles                  "
+    echo "  --lockstep         Step vehicles in simulated"
+    echo "                     time with uLockstepClock  "
     echo "  --uMayFinish                                 "
     echo "    Launch uMayFinish after launching the      "
     echo "    mission. By default the max_db_uptime is   "
@@ -213,6 +217,8 @@ for ARGI; do
 	NOGUI="--nogui"
     elif [ "${ARGI}" = "--autodeploy" ]; then
     AUTODEPLOY="yes"
+    elif [ "${ARGI}" = "--lockstep" ]; then
+    LOCKSTEP="yes"
     elif [ "${ARGI}" = "--uMayFinish" ]; then
     LAUNCH_UMAYFINISH="yes"
     XLAUNCHED="yes"
@@ -453,6 +459,12 @@ do
         fi
     fi
 
+    # Every vehicle is simulated in steps, so each one must ack them
+    if [ "$LOCKSTEP" = "yes" ]; then
+        IVARGS+=" --lockstep"
+        LOCKSTEP_VNAMES+="${LOCKSTEP_VNAMES:+:}${VNAMES[$IXX]}"
+    fi
+
     if [ "${COMPETE}" != "" ]; then
 	VAPP="${VAPPS[$IXX]}"
 	IVARGS+=" --pgr=${VAPP} "
@@ -496,6 +508,9 @@ fi
 if [ "$AUTODEPLOY" = "yes" ]; then
     SARGS+=" --autodeploy=$VAMT"
 fi
+if [ "$LOCKSTEP" = "yes" ]; then
+    SARGS+=" --lockstep=$LOCKSTEP_VNAMES"
+fi
 
 vecho "Launching shoreside: $SARGS"
 ./launch_shoreside.sh $SARGS
@@ -37,6 +37,8 @@ LOGDIR="./"
 NOSTAMP="no"
 AUTODEPLOY="no"
 AUTODEPLOY_NUM_NODES=-1
+LOCKSTEP="no"
+LOCKSTEP_VNAMES=""
 
 #--------------------------------------------------------------
 #  Part 2: Check for and handle command-line arguments
@@ -57,6 +59,9 @@ for ARGI; do
     echo "  --autodeploy=<num-nodes>                     "
     echo "    Auto deploy once the required number of    "
     echo "    nodes (vehicles) have spun up              "
+    echo "  --lockstep=<vnames>                          "
+    echo "    Run uLockstepClock, with these (colon      "
+    echo "    separated) vehicles acking each step       "
     echo "  --nogui, -n                                  "
     echo "    Headless mode - no pMarineViewer etc       "
     echo "  --trim, -t         Trim logging for learning "
@@ -103,6 +108,9 @@ for ARGI; do
             echo "Error: Not a valid number for --autodeploy: $AUTODEPLOY_NUM_NODES. Exit code 2"
             exit 2
         fi
+    elif [ "${ARGI:0:11}" = "--lockstep=" ]; then
+        LOCKSTEP="yes"
+        LOCKSTEP_VNAMES="${ARGI#--lockstep=}"
     elif [ "${ARGI}" = "--nogui" -o "${ARGI}" = "-n" ]; then
         LAUNCH_GUI="no"
     elif [ "${ARGI}" = "--trim" -o "${ARGI}" = "-t" ]; then
@@ -173,6 +181,8 @@ if [ "${VERBOSE}" = "yes" ]; then
     echo "AUTO_LAUNCHED = [${AUTO_LAUNCHED}]"
     echo "AUTODEPLOY =   [${AUTODEPLOY}]    "
     echo "AUTODEPLOY_NUM_NODES = [${AUTODEPLOY_NUM_NODES}]"
+    echo "LOCKSTEP =      [${LOCKSTEP}]     "
+    echo "LOCKSTEP_VNAMES = [${LOCKSTEP_VNAMES}]"
     echo "----------------------------------"
     echo "IP_ADDR =       [${IP_ADDR}]      "
     echo "MOOS_PORT =     [${MOOS_PORT}]    "
@@ -215,7 +225,8 @@ nsplug meta_shoreside.moos targ_shoreside.moos $NSFLAGS WARP=$TIME_WARP \
        MMOD=$MMOD                   VNAMES=$VNAMES          \
        SWIM_FILE=$SWIM_FILE         TRIM=$TRIM              \
        LOGDIR=$LOGDIR               NOSTAMP=$NOSTAMP        \
-       AUTODEPLOY=$AUTODEPLOY       AUTODEPLOY_NUM_NODES=$AUTODEPLOY_NUM_NODES
+       AUTODEPLOY=$AUTODEPLOY       AUTODEPLOY_NUM_NODES=$AUTODEPLOY_NUM_NODES \
+       LOCKSTEP=$LOCKSTEP           LOCKSTEP_VNAMES=$LOCKSTEP_VNAMES
 
 if [ "${JUST_MAKE}" = "yes" ]; then
     echo "$ME: Targ files made; exiting without launch."
@@ -55,6 +55,7 @@ NOSTAMP="no"
 R_SWIMMER_SECTORS=8
 R_VEHICLE_SECTORS=8
 R_SENSE_VEHICLES="no"
+LOCKSTEP="no"
 DIAMOND_PATTERN="14.82,-11.42:-17.51,-59.95:40.52,-65.63:72.85,-17.11"
 PRIMARY_BEHAVIOR_WEIGHT=100
 COLREGS_WEIGHT=350
@@ -138,6 +139,9 @@ for ARGI; do
     echo "    Number of vehicle sectors for rescue vehicles"
     echo "    (default: 8). When set, implies              "
     echo "    --r_sense_vehicles                           "
+    echo "  --lockstep                                     "
+    echo "    Simulate and sense on uLockstepClock ticks   "
+    echo "    (uSimLockstep, pSectorSense). Needs --sim    "
     echo "  --trim, -t           Trim logging for learning "
     echo "  --logdir, -ld        Directory to save log info"
     echo "  --nostamp       Do not include timestamp       "
@@ -205,6 +209,8 @@ for ARGI; do
     elif [ "${ARGI:0:20}" = "--r_vehicle_sectors=" ]; then
         R_VEHICLE_SECTORS="${ARGI#--r_vehicle_sectors=*}"
         R_SENSE_VEHICLES="yes"
+    elif [ "${ARGI}" = "--lockstep" ]; then
+        LOCKSTEP="yes"
 
     elif [ "${ARGI}" = "--trim" -o "${ARGI}" = "-t" ]; then
 	    TRIM="yes"
@@ -250,6 +256,14 @@ if [ "${VROLE}" = "scout" ]; then
     fi
 fi
 
+#--------------------------------------------------------------
+#  Part 4C: Lockstep steps the simulator, so there must be one
+#--------------------------------------------------------------
+if [ "${LOCKSTEP}" = "yes" -a "${XMODE}" != "SIM" ]; then
+    echo "$ME: --lockstep requires --sim. Exit Code 5."
+    exit 5
+fi
+
 #---------------------------------------------------------------
 #  Part 5: If verbose, show vars and confirm before launching
 #---------------------------------------------------------------
@@ -292,6 +306,7 @@ if [ "${VERBOSE}" = "yes" ]; then
     echo "R_SWIMMER_SECTORS = [${R_SWIMMER_SECTORS}]"
     echo "R_SENSE_VEHICLES =  [${R_SENSE_VEHICLES}] "
     echo "R_VEHICLE_SECTORS = [${R_VEHICLE_SECTORS}]"
+    echo "LOCKSTEP =          [${LOCKSTEP}]         "
     echo "----------------------------------"
     echo "TRIM =          [${TRIM}]         "
     echo "LOGDIR =        [${LOGDIR}]       "
@@ -344,6 +359,7 @@ nsplug meta_vehicle.moos targ_$VNAME.moos $NSFLAGS WARP=$TIME_WARP \
        SWIMMER_SECTORS=$R_SWIMMER_SECTORS \
        VEHICLE_SECTORS=$R_VEHICLE_SECTORS \
        R_SENSE_VEHICLES=$R_SENSE_VEHICLES \
+       LOCKSTEP=$LOCKSTEP \
        NEURAL_NETWORK_CONFIG=$NEURAL_NETWORK_CONFIG
 
 nsplug meta_vehicle.bhv targ_$VNAME.bhv $NSFLAGS         \
@@ -95,6 +95,8 @@ class Sweep():
             f'--logdir={logdir}',
             '--nogui'
         ]
+        if self.args.lockstep:
+            cmd.append('--lockstep')
 
         # Execute command with learnKill first, then launch.sh in the correct directory
         try:
@@ -136,6 +138,8 @@ def main():
                         help='Moos timeout for mission evaluation in seconds (default: 600)')
     parser.add_argument('--max_retries', type=int, default=10,
                         help='Maximum number of retries for any particular trial (default: 10)')
+    parser.add_argument('--lockstep', action='store_true',
+                        help='Step the simulation with uLockstepClock (default: off)')
 
     args = parser.parse_args()
 
@@ -0,0 +1,119 @@
+#include "bench_harness.h"
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <iomanip>
+#include <algorithm>
+#include <unistd.h>
+
+static const uint64_t MAX_ITERATIONS = 1000000000;
+
+void BenchRunner::add(const std::string& name, BenchFunc func) {
+  m_benchmarks.emplace_back(name, func);
+}
+
+BenchRunner::Result BenchRunner::runOne(const std::string& name, const BenchFunc& func) const {
+  Result result;
+  result.name = name;
+
+  uint64_t iterations = 1;
+  while (true) {
+    BenchState state;
+    state.iterations = iterations;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::clock_t cpu_start = std::clock();
+    func(state);
+    std::clock_t cpu_end = std::clock();
+    double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = double(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+
+    if (real >= m_min_time || iterations >= MAX_ITERATIONS) {
+      result.iterations = iterations;
+      result.real_ns = real * 1e9 / iterations;
+      result.cpu_ns = cpu * 1e9 / iterations;
+      if (real > 0) {
+        result.bytes_per_second = state.bytes_processed / real;
+        result.items_per_second = state.items_processed / real;
+      }
+      return result;
+    }
+
+    // Aim a little past the minimum time, growing at most 10x per try
+    double scale = (real > 0) ? 1.4 * m_min_time / real : 10.0;
+    scale = std::min(std::max(scale, 2.0), 10.0);
+    iterations = std::min<uint64_t>(MAX_ITERATIONS, iterations * scale);
+  }
+}
+
+void BenchRunner::run(std::ostream& log) {
+  m_results.clear();
+  log << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "Time (ns)"
+      << std::setw(14) << "CPU (ns)" << std::setw(12) << "Iterations" << "  Throughput" << std::endl;
+
+  for (const std::pair<std::string, BenchFunc>& bench : m_benchmarks) {
+    if (!m_filter.empty() && bench.first.find(m_filter) == std::string::npos) continue;
+
+    Result result = runOne(bench.first, bench.second);
+    m_results.push_back(result);
+
+    log << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(0)
+        << std::setw(14) << result.real_ns << std::setw(14) << result.cpu_ns
+        << std::setw(12) << result.iterations;
+    if (result.bytes_per_second > 0)
+      log << "  " << std::setprecision(1) << result.bytes_per_second / 1.0e6 << " MB/s";
+    if (result.items_per_second > 0)
+      log << "  " << std::setprecision(3) << result.items_per_second / 1.0e6 << " M items/s";
+    log << std::endl;
+  }
+}
+
+// Quote a string for JSON
+static std::string jsonString(const std::string& str) {
+  std::string out = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') out += '\\';
+    if ((unsigned char)c < 0x20) continue;
+    out += c;
+  }
+  return out + "\"";
+}
+
+void BenchRunner::writeJson(std::ostream& out, const std::string& executable,
+                            const std::string& build_type) const {
+  char host[256] = "";
+  gethostname(host, sizeof(host) - 1);
+  std::time_t now = std::time(nullptr);
+  char date[64] = "";
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+  out << std::setprecision(10);
+  out << "{\n";
+  out << "  \"context\": {\n";
+  out << "    \"date\": " << jsonString(date) << ",\n";
+  out << "    \"host_name\": " << jsonString(host) << ",\n";
+  out << "    \"executable\": " << jsonString(executable) << ",\n";
+  out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+  out << "    \"library_build_type\": " << jsonString(build_type) << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [";
+  for (size_t i = 0; i < m_results.size(); i++) {
+    const Result& result = m_results[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"name\": " << jsonString(result.name) << ",\n";
+    out << "      \"run_name\": " << jsonString(result.name) << ",\n";
+    out << "      \"run_type\": \"iteration\",\n";
+    out << "      \"iterations\": " << result.iterations << ",\n";
+    out << "      \"real_time\": " << result.real_ns << ",\n";
+    out << "      \"cpu_time\": " << result.cpu_ns << ",\n";
+    out << "      \"time_unit\": \"ns\"";
+    if (result.bytes_per_second > 0)
+      out << ",\n      \"bytes_per_second\": " << result.bytes_per_second;
+    if (result.items_per_second > 0)
+      out << ",\n      \"items_per_second\": " << result.items_per_second;
+    out << "\n    }";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
@@ -0,0 +1,65 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <cstdint>
+
+// Handed to each benchmark. The benchmark does its work `iterations`
+// times and may report how many bytes or items that covered, so the
+// results include throughput.
+struct BenchState {
+  uint64_t iterations = 1;
+  uint64_t bytes_processed = 0;
+  uint64_t items_processed = 0;
+};
+
+using BenchFunc = std::function<void(BenchState&)>;
+
+// Keep the compiler from optimizing away a value a benchmark computed
+template <typename T>
+inline void benchKeep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Small in-tree replacement for Google Benchmark. Each benchmark is run
+// with a growing iteration count until one run takes at least the
+// minimum time, and that run is reported. The JSON written by writeJson()
+// follows Google Benchmark's layout, so its compare tools can diff two
+// result files.
+class BenchRunner {
+  public:
+    struct Result {
+      std::string name;
+      uint64_t iterations = 0;
+      double real_ns = 0;  // per iteration
+      double cpu_ns = 0;   // per iteration
+      double bytes_per_second = 0;
+      double items_per_second = 0;
+    };
+
+    void add(const std::string& name, BenchFunc func);
+
+    // Only run benchmarks whose name contains filter
+    void setFilter(const std::string& filter) { m_filter = filter; }
+    void setMinTime(double seconds) { m_min_time = seconds; }
+
+    // Run the selected benchmarks, printing one line per result to log
+    void run(std::ostream& log);
+
+    const std::vector<Result>& results() const { return m_results; }
+    void writeJson(std::ostream& out, const std::string& executable,
+                   const std::string& build_type) const;
+
+  private:
+    Result runOne(const std::string& name, const BenchFunc& func) const;
+
+    std::vector<std::pair<std::string, BenchFunc>> m_benchmarks;
+    std::vector<Result> m_results;
+    std::string m_filter;
+    double m_min_time = 0.5;
+};
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,363 @@
+#include "bench_harness.h"
+#include "sector_sensor.h"
+#include "network.h"
+#include "general_utils.h"
+#include "MBUtils.h"
+#include "IvPDomain.h"
+#include "IvPFunction.h"
+#include "OF_Reflector.h"
+#include "AOF_SimpleWaypoint.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <filesystem>
+#include <random>
+#include <unistd.h>
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+// Swallows the debug printing some of the benchmarked code does
+class NullBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+static Entities randomEntities(size_t count, double radius, std::mt19937& rng) {
+  std::uniform_real_distribution<double> coord(-radius, radius);
+  Entities entities;
+  for (size_t i = 0; i < count; i++) {
+    double x = coord(rng);
+    double y = coord(rng);
+    entities.push_back(XYPoint(x, y));
+  }
+  return entities;
+}
+
+// SectorSensor::query, with entities spread over twice the sensor radius
+// so some of them are out of range
+static void addSectorSensorBenchmarks(BenchRunner& runner) {
+  for (int sectors : {4, 8, 16, 32}) {
+    for (size_t entities : {10, 100, 1000, 10000}) {
+      std::string name = "SectorSensor/query/sectors:" + std::to_string(sectors) +
+                         "/entities:" + std::to_string(entities);
+      runner.add(name, [sectors, entities](BenchState& state) {
+        std::mt19937 rng(1);
+        Entities points = randomEntities(entities, 100.0, rng);
+        SectorSensor sensor(50.0, 1.0, sectors, NormalizationRule::DYNAMIC);
+        sensor.setVerbose(0);
+        double heading = 0;
+        for (uint64_t i = 0; i < state.iterations; i++) {
+          std::vector<double> readings = sensor.query(points, 0.0, 0.0, heading);
+          benchKeep(readings.data());
+          heading = (heading >= 359.0) ? 0.0 : heading + 1.0;
+        }
+        state.items_processed = state.iterations * entities;
+      });
+    }
+  }
+}
+
+// NeuralNetwork::forward for a few topologies, inputs sized like sector
+// readings and two outputs like the heading/speed network
+static void addNeuralNetworkBenchmarks(BenchRunner& runner) {
+  std::vector<std::vector<int>> topologies = {
+    {8, 8, 2}, {16, 16, 2}, {16, 32, 32, 2}, {32, 64, 64, 2}};
+
+  for (const std::vector<int>& structure : topologies) {
+    std::string topology;
+    size_t num_weights = 0;
+    for (size_t i = 0; i < structure.size(); i++) {
+      topology += (i == 0 ? "" : "-") + std::to_string(structure[i]);
+      if (i + 1 < structure.size()) num_weights += (structure[i] + 1) * structure[i + 1];
+    }
+
+    runner.add("NeuralNetwork/forward/" + topology, [structure, num_weights](BenchState& state) {
+      std::mt19937 rng(2);
+      std::uniform_real_distribution<double> val(-1.0, 1.0);
+      std::vector<double> weights(num_weights);
+      for (double& w : weights) w = val(rng);
+      std::vector<std::vector<double>> bounds(structure.back(), std::vector<double>{-1.0, 1.0});
+      std::vector<double> inputs(structure.front());
+      for (double& in : inputs) in = val(rng);
+
+      NeuralNetwork network(weights, structure, bounds);
+      for (uint64_t i = 0; i < state.iterations; i++) {
+        std::vector<double> outputs = network.forward(inputs);
+        benchKeep(outputs.data());
+      }
+      state.items_processed = state.iterations;
+    });
+  }
+}
+
+// Formatting a SECTOR_SENSOR_READING in pSectorSense and parsing it back
+// the way the behaviors do
+static void addSectorReadingBenchmarks(BenchRunner& runner) {
+  for (size_t count : {8, 16, 32, 64}) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> val(0.0, 2.0);
+    std::vector<double> readings(count);
+    for (double& r : readings) r = val(rng);
+    std::string reading_str = vectorToStream(readings, ",");
+
+    runner.add("SectorReading/format/" + std::to_string(count), [readings](BenchState& state) {
+      for (uint64_t i = 0; i < state.iterations; i++) {
+        std::string str = vectorToStream(readings, ",");
+        benchKeep(str.data());
+      }
+      state.items_processed = state.iterations * readings.size();
+    });
+
+    runner.add("SectorReading/parse/" + std::to_string(count), [reading_str](BenchState& state) {
+      std::vector<double> parsed;
+      for (uint64_t i = 0; i < state.iterations; i++) {
+        parsed.clear();
+        std::vector<std::string> parts = parseString(reading_str, ',');
+        for (const std::string& part : parts) {
+          double d;
+          if (setDoubleOnString(d, part)) parsed.push_back(d);
+        }
+        benchKeep(parsed.data());
+      }
+      state.bytes_processed = state.iterations * reading_str.size();
+      state.items_processed = state.iterations * parsed.size();
+    });
+  }
+}
+
+// Write a shoreside-style alog with interleaved node reports from a few
+// vehicles and some other traffic
+static void writeSyntheticAlog(const std::string& path, size_t num_lines) {
+  std::ofstream out(path);
+  out << "%% LOG FILE:  bench\n%% synthetic shoreside log\n\n";
+  const char* names[] = {"abe", "ben", "cal", "deb"};
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<double> step(-0.5, 0.5);
+  double x[4] = {0, 50, 100, 150}, y[4] = {0, -50, 50, 0};
+  out << std::fixed << std::setprecision(2);
+  for (size_t i = 0; i < num_lines; i++) {
+    double time = 0.01 * (i + 1);
+    if (i % 10 == 9) {
+      out << time << "   DESIRED_HEADING   pHelmIvP   " << (i % 360) << "\n";
+      continue;
+    }
+    int v = i % 4;
+    x[v] += step(rng);
+    y[v] += step(rng);
+    out << time << "   NODE_REPORT   pNodeReporter   NAME=" << names[v] << ",X=" << x[v] << ",Y=" << y[v]
+        << ",SPD=1.0,HDG=" << (i % 360) << ",DEP=0,TYPE=kayak,MODE=MODE@ACTIVE:SURVEYING,TIME=" << time << "\n";
+  }
+}
+
+static void addNodeReportBenchmarks(BenchRunner& runner, const std::string& dir) {
+  std::string alog = dir + "/bench_SHORESIDE.alog";
+  writeSyntheticAlog(alog, 200000);
+  uintmax_t alog_size = std::filesystem::file_size(alog);
+
+  for (bool binary : {false, true}) {
+    std::string out_dir = dir + (binary ? "/positions_bin" : "/positions_csv");
+    std::filesystem::create_directories(out_dir);
+    runner.add(std::string("processNodeReports/200k_lines") + (binary ? "/binary" : ""),
+               [alog, out_dir, binary, alog_size](BenchState& state) {
+      for (uint64_t i = 0; i < state.iterations; i++) processNodeReports(alog, out_dir, binary);
+      state.bytes_processed = state.iterations * alog_size;
+    });
+  }
+}
+
+// The csv tools, run on the position files processNodeReports writes
+static void addCsvBenchmarks(BenchRunner& runner, const std::string& dir) {
+  std::string positions = dir + "/csv_tools";
+  std::filesystem::create_directories(positions);
+  processNodeReports(dir + "/bench_SHORESIDE.alog", positions);
+  csvMergeFiles(positions);
+
+  std::string team_csv = positions + "/team_positions.csv";
+  std::string copy_csv = dir + "/team_copy.csv";
+  std::filesystem::copy_file(team_csv, copy_csv, std::filesystem::copy_options::overwrite_existing);
+  uintmax_t team_size = std::filesystem::file_size(team_csv);
+
+  runner.add("csvFilesAreEqual/equal", [team_csv, copy_csv, team_size](BenchState& state) {
+    for (uint64_t i = 0; i < state.iterations; i++) benchKeep(csvFilesAreEqual(team_csv, copy_csv));
+    state.bytes_processed = state.iterations * team_size;
+  });
+
+  // Same values written with an "e0" exponent, so every field has to be
+  // parsed
+  std::string near_csv = dir + "/team_near.csv";
+  std::ifstream in(team_csv);
+  std::ofstream near(near_csv);
+  std::string row;
+  std::getline(in, row);
+  near << row << "\n";
+  while (std::getline(in, row)) {
+    for (size_t comma = row.find(','); comma != std::string::npos; comma = row.find(',', comma + 3))
+      row.insert(comma, "e0");
+    near << row << "e0\n";
+  }
+  near.close();
+
+  runner.add("csvFilesAreClose/near", [team_csv, near_csv, team_size](BenchState& state) {
+    for (uint64_t i = 0; i < state.iterations; i++) benchKeep(csvFilesAreClose(team_csv, near_csv));
+    state.bytes_processed = state.iterations * team_size;
+  });
+
+  std::vector<std::pair<std::string, DuplicateFilterMode>> modes = {
+    {"exact", DuplicateFilterMode::Exact},
+    {"fingerprint", DuplicateFilterMode::Fingerprint},
+    {"consecutive", DuplicateFilterMode::Consecutive}};
+  for (const std::pair<std::string, DuplicateFilterMode>& mode : modes) {
+    std::string out_csv = dir + "/team_filtered.csv";
+    DuplicateFilterMode filter_mode = mode.second;
+    runner.add("csvFilterDuplicateRows/" + mode.first,
+               [team_csv, out_csv, filter_mode, team_size](BenchState& state) {
+      for (uint64_t i = 0; i < state.iterations; i++) csvFilterDuplicateRows(team_csv, out_csv, 0, filter_mode);
+      state.bytes_processed = state.iterations * team_size;
+    });
+  }
+
+  for (bool by_time : {false, true}) {
+    runner.add(std::string("csvMergeFiles/") + (by_time ? "by_time" : "append"),
+               [positions, by_time, team_size](BenchState& state) {
+      for (uint64_t i = 0; i < state.iterations; i++) csvMergeFiles(positions, {}, by_time);
+      state.bytes_processed = state.iterations * team_size;
+    });
+  }
+}
+
+static void initWaypointAof(AOF_SimpleWaypoint& aof) {
+  aof.setParam("desired_speed", 1.5);
+  aof.setParam("osx", 0);
+  aof.setParam("osy", 0);
+  aof.setParam("ptx", 80);
+  aof.setParam("pty", -45);
+  aof.initialize();
+}
+
+// AOF_SimpleWaypoint over the decision domain the missions use, scored
+// one point at a time (what the reflector did) and as one batch, and the
+// reflector build in BHV_SimpleWaypoint with and without the grid cache
+static void addSimpleWaypointBenchmarks(BenchRunner& runner) {
+  IvPDomain domain;
+  domain.addDomain("course", 0, 359, 360);
+  domain.addDomain("speed", 0, 3, 31);
+  size_t grid_points = 360 * 31;
+
+  runner.add("AOF_SimpleWaypoint/evalPoint/grid", [domain, grid_points](BenchState& state) {
+    AOF_SimpleWaypoint aof(domain);
+    initWaypointAof(aof);
+    std::vector<double> point(2);
+    int crs_ix = domain.getIndex("course");
+    int spd_ix = domain.getIndex("speed");
+    for (uint64_t i = 0; i < state.iterations; i++) {
+      double sum = 0;
+      for (unsigned int c = 0; c < 360; c++) {
+        for (unsigned int s = 0; s < 31; s++) {
+          point[crs_ix] = c;
+          point[spd_ix] = s * 0.1;
+          sum += aof.evalPoint(point);
+        }
+      }
+      benchKeep(sum);
+    }
+    state.items_processed = state.iterations * grid_points;
+  });
+
+  runner.add("AOF_SimpleWaypoint/evalGrid", [domain, grid_points](BenchState& state) {
+    AOF_SimpleWaypoint aof(domain);
+    initWaypointAof(aof);
+    std::vector<double> values;
+    for (uint64_t i = 0; i < state.iterations; i++) {
+      aof.evalGrid(values);
+      benchKeep(values.data());
+    }
+    state.items_processed = state.iterations * grid_points;
+  });
+
+  for (bool cached : {false, true}) {
+    runner.add(std::string("OF_Reflector/create_600_500/") + (cached ? "batch" : "pointwise"),
+               [domain, cached](BenchState& state) {
+      for (uint64_t i = 0; i < state.iterations; i++) {
+        AOF_SimpleWaypoint aof(domain);
+        initWaypointAof(aof);
+        if (cached) aof.cacheGrid();
+        OF_Reflector reflector(&aof);
+        reflector.create(600, 500);
+        IvPFunction* ipf = reflector.extractIvPFunction();
+        benchKeep(ipf);
+        delete ipf;
+      }
+      state.items_processed = state.iterations;
+    });
+  }
+}
+
+static void usage(const char* prog) {
+  std::cerr << "Usage: " << prog << " [--filter <text>] [--min-time <seconds>] [--json <file>]" << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "  --filter <text>      Only run benchmarks whose name contains text" << std::endl;
+  std::cerr << "  --min-time <seconds> Minimum time to run each benchmark (default: 0.5)" << std::endl;
+  std::cerr << "  --json <file>        Write the results as JSON, - for stdout" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  BenchRunner runner;
+  std::string json_path;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--filter" && i + 1 < argc) {
+      runner.setFilter(argv[++i]);
+    } else if (arg == "--min-time" && i + 1 < argc) {
+      try {
+        runner.setMinTime(std::stod(argv[++i]));
+      } catch (const std::exception& e) {
+        std::cerr << "Invalid minimum time (This argument must be a number): " << argv[i] << std::endl;
+        return 1;
+      }
+    } else if (arg == "--json" && i + 1 < argc) {
+      json_path = argv[++i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  // Inputs for the file benchmarks go in a scratch directory
+  std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                              ("bench_" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+
+  addSectorSensorBenchmarks(runner);
+  addNeuralNetworkBenchmarks(runner);
+  addSectorReadingBenchmarks(runner);
+  addNodeReportBenchmarks(runner, dir.string());
+  addCsvBenchmarks(runner, dir.string());
+  addSimpleWaypointBenchmarks(runner);
+
+  // The table goes to the real stdout (or stderr when the JSON goes
+  // there) while std::cout is silenced for the benchmarks themselves
+  NullBuffer null_buffer;
+  std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+  std::ostream table(cout_buffer);
+  runner.run(json_path == "-" ? std::cerr : table);
+  std::cout.rdbuf(cout_buffer);
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+
+  if (json_path == "-") {
+    runner.writeJson(std::cout, argv[0], BENCH_BUILD_TYPE);
+  } else if (!json_path.empty()) {
+    std::ofstream out(json_path);
+    if (!out.is_open()) {
+      std::cerr << "Failed to write results: " << json_path << std::endl;
+      return 2;
+    }
+    runner.writeJson(out, argv[0], BENCH_BUILD_TYPE);
+  }
+  return 0;
+}
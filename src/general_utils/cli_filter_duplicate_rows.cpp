@@ -1,25 +1,40 @@
 #include "general_utils.h"
 
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <input_csv> <output_csv> [verbose] [--fingerprint | --consecutive]" << std::endl;
+    std::cerr << "  --fingerprint  Remember rows by 64-bit hash instead of in full" << std::endl;
+    std::cerr << "  --consecutive  Only drop rows identical to the row right before them" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 3 || argc > 4) {
-        std::cerr << "Usage: " << argv[0] << " <input_csv> <output_csv> [verbose]" << std::endl;
+    if (argc < 3 || argc > 5) {
+        usage(argv[0]);
         return 1;
     }
 
     std::string input_csv = argv[1];
     std::string output_csv = argv[2];
     int verbose = 0;
+    DuplicateFilterMode mode = DuplicateFilterMode::Exact;
 
-    if (argc == 4) {
-        try {
-            verbose = std::stoi(argv[3]);
-        } catch (const std::exception& e) {
-            std::cerr << "Invalid verbosity level (This argument must be an integer): " << argv[3] << std::endl;
-            return 1;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--fingerprint") {
+            mode = DuplicateFilterMode::Fingerprint;
+        } else if (arg == "--consecutive") {
+            mode = DuplicateFilterMode::Consecutive;
+        } else {
+            try {
+                verbose = std::stoi(arg);
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid verbosity level (This argument must be an integer): " << arg << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
         }
     }
 
-    if (csvFilterDuplicateRows(input_csv, output_csv, verbose))
+    if (csvFilterDuplicateRows(input_csv, output_csv, verbose, mode))
         return 0;
     else
         return 2;
@@ -0,0 +1,200 @@
+#include "swim_file.h"
+#include "general_utils.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+static const char* PAV_60 = "60,10:-30.3602,-32.8374:-4.6578,-87.0535:85.7024,-44.2161";
+static const char* PAV_90 = "60,10:-75.5402,-54.2561:-36.9866,-135.58:98.5536,-71.3241";
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " --poly=<x,y:x,y:...> [options]" << std::endl;
+    std::cerr << "       " << prog << " --check=<swim_file> [--sep=<D>]" << std::endl;
+    std::cerr << "  --poly=<pts>       Region to place swimmers in" << std::endl;
+    std::cerr << "  --pav60, --pav90   Use a standard region instead of --poly" << std::endl;
+    std::cerr << "  --swimmers=<N>     Registered swimmers (default 15)" << std::endl;
+    std::cerr << "  --unreg=<N>        Unregistered swimmers (default 0)" << std::endl;
+    std::cerr << "  --sep=<D>          Minimum distance between swimmers (default 0)" << std::endl;
+    std::cerr << "  --seed=<S>         Random seed (default: random, recorded in the file)" << std::endl;
+    std::cerr << "  --precision=<P>    Decimals in swimmer positions (default 1)" << std::endl;
+    std::cerr << "  --count=<K>        Number of files, with seeds S..S+K-1 (needs --out)" << std::endl;
+    std::cerr << "  --out=<prefix>     Write <prefix>_NNN.txt (or <prefix>.txt for one" << std::endl;
+    std::cerr << "                     file) instead of printing to stdout" << std::endl;
+    std::cerr << "  --check=<file>     Summarize an existing swim file and exit, failing" << std::endl;
+    std::cerr << "                     if swimmers are outside its poly or closer than --sep" << std::endl;
+}
+
+// Summary of an existing swim file on stdout. Returns the exit code.
+static int checkSwimFile(const std::string& path, double sep) {
+    SwimScenario scenario;
+    unsigned int bad_line = 0;
+    if (!loadSwimFile(path, scenario, &bad_line)) {
+        if (bad_line > 0)
+            std::cerr << path << ":" << bad_line << ": bad poly or swimmer line" << std::endl;
+        else
+            std::cerr << "Could not open " << path << std::endl;
+        return 2;
+    }
+
+    unsigned int unreg = 0;
+    for (const SwimmerSpec& swimmer : scenario.swimmers)
+        if (swimmer.type == "unreg") unreg++;
+
+    unsigned int outside = 0;
+    PolygonGrid region;
+    if (region.build(scenario.poly_xs, scenario.poly_ys, 0)) {
+        for (const SwimmerSpec& swimmer : scenario.swimmers)
+            if (!region.containsExact(swimmer.x, swimmer.y)) outside++;
+    }
+
+    double lowest = minSwimmerSeparation(scenario);
+    printf("%s: %zu swimmers (%u unreg), %zu poly vertices, lowest dist %.2f, %u outside poly\n",
+           path.c_str(), scenario.swimmers.size(), unreg, scenario.poly_xs.size(), lowest, outside);
+    bool too_close = (scenario.swimmers.size() > 1) && (lowest < sep);
+    return (outside > 0 || too_close) ? 2 : 0;
+}
+
+static bool parseUnsigned(const std::string& str, unsigned long long& val) {
+    if (str.empty() || str[0] == '-') return false;
+    try {
+        size_t used = 0;
+        val = std::stoull(str, &used);
+        return used == str.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string poly_spec;
+    unsigned long long swimmers = 15;
+    unsigned long long unreg = 0;
+    unsigned long long count = 1;
+    unsigned long long precision = 1;
+    unsigned long long seed = 0;
+    bool seed_set = false;
+    double sep = 0;
+    std::string out_prefix;
+    std::string check_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+        bool ok = true;
+        if (arg == "--help" || arg == "-h") {
+            usage(argv[0]);
+            return 0;
+        } else if (arg == "--pav60") {
+            poly_spec = PAV_60;
+        } else if (arg == "--pav90") {
+            poly_spec = PAV_90;
+        } else if (key == "--poly") {
+            poly_spec = value;
+        } else if (key == "--swimmers") {
+            ok = parseUnsigned(value, swimmers) && (swimmers <= UINT32_MAX);
+        } else if (key == "--unreg") {
+            ok = parseUnsigned(value, unreg) && (unreg <= UINT32_MAX);
+        } else if (key == "--count") {
+            ok = parseUnsigned(value, count) && (count > 0);
+        } else if (key == "--precision") {
+            ok = parseUnsigned(value, precision) && (precision <= 9);
+        } else if (key == "--seed") {
+            ok = parseUnsigned(value, seed);
+            seed_set = true;
+        } else if (key == "--sep") {
+            ok = parseDoubleView(value, sep) && (sep >= 0);
+        } else if (key == "--check") {
+            check_file = value;
+            ok = !value.empty();
+        } else if (key == "--out") {
+            out_prefix = value;
+            ok = !value.empty();
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Bad argument: " << arg << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!check_file.empty()) return checkSwimFile(check_file, sep);
+
+    std::vector<double> xs, ys;
+    if (!parsePolyPoints(poly_spec, xs, ys) || xs.size() < 3) {
+        std::cerr << "A region of at least 3 vertices is needed (--poly or --pav60/--pav90)" << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+    // generate() counts swimmers in an unsigned int
+    if (swimmers + unreg > UINT32_MAX) {
+        std::cerr << "Too many swimmers: " << swimmers + unreg << std::endl;
+        return 1;
+    }
+    if (count > 1 && out_prefix.empty()) {
+        std::cerr << "--count needs --out" << std::endl;
+        return 1;
+    }
+    if (!seed_set) {
+        std::random_device rd;
+        seed = ((unsigned long long)rd() << 32) ^ rd();
+    }
+
+    SwimFieldGenerator generator;
+    if (!generator.setRegion(xs, ys)) {
+        std::cerr << "Invalid region: " << poly_spec << std::endl;
+        return 1;
+    }
+    generator.setSeparation(sep);
+    generator.setPrecision((int)precision);
+
+    auto start = std::chrono::steady_clock::now();
+    SwimScenario scenario;
+    for (unsigned long long k = 0; k < count; k++) {
+        unsigned long long file_seed = seed + k;
+        if (!generator.generate((unsigned int)swimmers, (unsigned int)unreg, file_seed, scenario)) {
+            std::cerr << "Could not fit " << swimmers + unreg << " swimmers " << sep
+                      << " apart in the region (seed " << file_seed << ")" << std::endl;
+            return 2;
+        }
+
+        std::ostringstream header;
+        header << "gen_swim_file --poly=" << poly_spec << " --swimmers=" << swimmers
+               << " --unreg=" << unreg << " --sep=" << sep << " --seed=" << file_seed;
+        if (precision != 1) header << " --precision=" << precision;
+        char dist[64];
+        snprintf(dist, sizeof(dist), "Lowest dist between swimmers: %.2f", minSwimmerSeparation(scenario));
+        header << "\n" << dist;
+
+        if (out_prefix.empty()) {
+            std::cout << formatSwimFile(scenario, header.str(), (int)precision);
+            continue;
+        }
+
+        std::string path = out_prefix;
+        if (count > 1) {
+            char suffix[32];
+            snprintf(suffix, sizeof(suffix), "_%03llu", k);
+            path += suffix;
+        }
+        path += ".txt";
+        if (!writeSwimFile(path, scenario, header.str(), (int)precision)) {
+            std::cerr << "Could not write " << path << std::endl;
+            return 2;
+        }
+    }
+
+    if (count > 1) {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Wrote " << count << " swim files in " << secs << " s ("
+                  << (secs > 0 ? count / secs : 0) << " per second)" << std::endl;
+    }
+    return 0;
+}
@@ -4,28 +4,34 @@
 #include <iostream>
 
 int main(int argc, char* argv[]) {
+    std::string usage = std::string("Usage: ") + argv[0] +
+        " <directory> [-e <vehicle>] [--exclude <vehicle>] ... [-t | --by-time]";
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <directory> [-e <vehicle>] [--exclude <vehicle>] ..." << std::endl;
+        std::cerr << usage << std::endl;
         return 1;
     }
 
     std::string directory = argv[1];
     std::vector<std::string> exclude_vehicles;
+    bool merge_by_time = false;
 
-    // Parse exclude flags only if they are at the end
+    // Parse flags only if they are at the end
     int i = 2;
     while (i < argc) {
         std::string arg = argv[i];
         if ((arg == "-e" || arg == "--exclude") && (i + 1 < argc)) {
             exclude_vehicles.push_back(argv[i + 1]);
             i += 2;
+        } else if (arg == "-t" || arg == "--by-time") {
+            merge_by_time = true;
+            i++;
         } else {
-            std::cerr << "Usage: " << argv[0] << " <directory> [-e <vehicle>] [--exclude <vehicle>] ..." << std::endl;
+            std::cerr << usage << std::endl;
             return 1;
         }
     }
 
-    if (csvMergeFiles(directory, exclude_vehicles))
+    if (csvMergeFiles(directory, exclude_vehicles, merge_by_time))
         return 0;
     else
         return 2;
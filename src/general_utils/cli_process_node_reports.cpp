@@ -1,15 +1,111 @@
 #include "general_utils.h"
+#include <thread>
+#include <iomanip>
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--binary] <shoreside_log_dir> <out_dir>" << std::endl;
+    std::cerr << "       " << prog << " --batch [-j <threads>] [--force] [--binary] <alog|dir> ..." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "  --batch      Convert many logs. Directories are searched for" << std::endl;
+    std::cerr << "               *SHORESIDE*.alog and each log's csv files go in a" << std::endl;
+    std::cerr << "               positions/ directory next to it." << std::endl;
+    std::cerr << "  -j <threads> Number of logs to convert at once (default: all cores)" << std::endl;
+    std::cerr << "  --force      Convert logs even if their output is up to date" << std::endl;
+    std::cerr << "  --binary     Also write a <name>_positions.bin twin of each csv" << std::endl;
+}
+
+static int runBatch(int argc, char* argv[]) {
+    unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    bool force = false;
+    bool binary = false;
+    std::vector<std::string> paths;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "-j" || arg == "--jobs") && (i + 1 < argc)) {
+            try {
+                num_threads = std::max(1, std::stoi(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid thread count (This argument must be an integer): " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--force") {
+            force = true;
+        } else if (arg == "--binary") {
+            binary = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<NodeReportJob> jobs;
+    for (const std::string& path : paths) {
+        std::vector<NodeReportJob> found = findNodeReportJobs(path);
+        for (NodeReportJob& job : found) job.binary = binary;
+        if (found.empty()) std::cerr << "No shoreside alogs found in: " << path << std::endl;
+        jobs.insert(jobs.end(), found.begin(), found.end());
+    }
+    if (jobs.empty()) return 2;
+
+    // Report each log as it finishes
+    auto report = [](const NodeReportJob& job) {
+        double mb = job.bytes / 1.0e6;
+        if (job.skipped)
+            std::cout << "skipped " << job.alog << " (up to date)" << std::endl;
+        else if (!job.ok)
+            std::cout << "FAILED  " << job.alog << std::endl;
+        else
+            std::cout << "done    " << job.alog << " (" << std::fixed << std::setprecision(1) << mb
+                      << " MB in " << std::setprecision(2) << job.seconds << " s, "
+                      << std::setprecision(1) << (job.seconds > 0 ? mb / job.seconds : 0.0)
+                      << " MB/s)" << std::endl;
+    };
+
+    bool ok = processNodeReportJobs(jobs, num_threads, force, report);
+
+    unsigned int converted = 0, skipped = 0, failed = 0;
+    double total_mb = 0, total_seconds = 0;
+    for (const NodeReportJob& job : jobs) {
+        if (!job.ok) failed++;
+        else if (job.skipped) skipped++;
+        else {
+            converted++;
+            total_mb += job.bytes / 1.0e6;
+            total_seconds += job.seconds;
+        }
+    }
+    std::cout << converted << " converted, " << skipped << " skipped, " << failed << " failed";
+    if (converted > 0)
+        std::cout << " (" << std::fixed << std::setprecision(1) << total_mb << " MB, "
+                  << std::setprecision(2) << total_seconds << " s of work, "
+                  << num_threads << " thread(s))";
+    std::cout << std::endl;
+
+    return ok ? 0 : 2;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <shoreside_log_dir> <out_dir>" << std::endl;
+    if (argc >= 2 && std::string(argv[1]) == "--batch")
+        return runBatch(argc, argv);
+
+    bool binary = (argc >= 2 && std::string(argv[1]) == "--binary");
+    int first = binary ? 2 : 1;
+    if (argc != first + 2) {
+        usage(argv[0]);
         return 1;
     }
 
-    std::string shoreside_log_dir = argv[1];
-    std::string out_dir = argv[2];
+    std::string shoreside_log_dir = argv[first];
+    std::string out_dir = argv[first + 1];
 
-    if (processNodeReports(shoreside_log_dir, out_dir))
+    if (processNodeReports(shoreside_log_dir, out_dir, binary))
         return 0;
     else
         return 2;
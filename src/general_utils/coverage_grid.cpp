@@ -0,0 +1,169 @@
+#include "coverage_grid.h"
+#include "polygon_grid.h"
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+static const char COVERAGE_MAGIC[4] = {'C', 'V', 'G', 'D'};
+static const uint32_t COVERAGE_VERSION = 1;
+
+template <typename T>
+static void writeRaw(std::ofstream& out, const T& val) {
+    out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+static bool readRaw(std::ifstream& in, T& val) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&val), sizeof(T)));
+}
+
+CoverageGrid::CoverageGrid() {
+    m_min_x = 0;
+    m_min_y = 0;
+    m_cell_size = 0;
+    m_cols = 0;
+    m_rows = 0;
+    m_region_cells = 0;
+    m_cells_visited = 0;
+}
+
+bool CoverageGrid::setRegion(const XYPolygon& poly, double cell_size) {
+    *this = CoverageGrid();
+
+    PolygonGrid region;
+    if (cell_size <= 0 || !region.build(poly, 0)) return false;
+
+    m_min_x = poly.get_min_x();
+    m_min_y = poly.get_min_y();
+    m_cell_size = cell_size;
+    m_cols = std::max(1u, (unsigned int)std::ceil((poly.get_max_x() - m_min_x) / cell_size));
+    m_rows = std::max(1u, (unsigned int)std::ceil((poly.get_max_y() - m_min_y) / cell_size));
+
+    // A cell belongs to the region if its center does
+    m_in_region.resize(m_cols * m_rows);
+    for (unsigned int row = 0; row < m_rows; row++) {
+        for (unsigned int col = 0; col < m_cols; col++) {
+            double cx = m_min_x + (col + 0.5) * cell_size;
+            double cy = m_min_y + (row + 0.5) * cell_size;
+            bool in = region.contains(cx, cy);
+            m_in_region[row * m_cols + col] = in;
+            if (in) m_region_cells++;
+        }
+    }
+    m_counts.assign(m_cols * m_rows, 0);
+    return true;
+}
+
+void CoverageGrid::reset() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_cells_visited = 0;
+}
+
+bool CoverageGrid::add(double x, double y) {
+    if (m_cols == 0) return false;
+    double fx = (x - m_min_x) / m_cell_size;
+    double fy = (y - m_min_y) / m_cell_size;
+    if (!(fx >= 0 && fy >= 0 && fx < m_cols && fy < m_rows)) return false;
+
+    unsigned int index = (unsigned int)fy * m_cols + (unsigned int)fx;
+    if (!m_in_region[index]) return false;
+
+    uint16_t& count = m_counts[index];
+    if (count < 0xFFFF) count++;
+    if (count > 1) return false;
+    m_cells_visited++;
+    return true;
+}
+
+bool CoverageGrid::merge(const CoverageGrid& other) {
+    if (m_cols != other.m_cols || m_rows != other.m_rows || m_cell_size != other.m_cell_size ||
+        m_min_x != other.m_min_x || m_min_y != other.m_min_y)
+        return false;
+
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        if (other.m_counts[i] == 0) continue;
+        if (m_counts[i] == 0) m_cells_visited++;
+        m_counts[i] = std::min<uint32_t>(0xFFFF, (uint32_t)m_counts[i] + other.m_counts[i]);
+    }
+    return true;
+}
+
+double CoverageGrid::coverage() const {
+    if (m_region_cells == 0) return 0;
+    return (double)m_cells_visited / m_region_cells;
+}
+
+bool CoverageGrid::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out.write(COVERAGE_MAGIC, sizeof(COVERAGE_MAGIC));
+    writeRaw(out, COVERAGE_VERSION);
+    writeRaw(out, m_min_x);
+    writeRaw(out, m_min_y);
+    writeRaw(out, m_cell_size);
+    writeRaw(out, (uint32_t)m_cols);
+    writeRaw(out, (uint32_t)m_rows);
+
+    std::vector<uint8_t> mask((m_in_region.size() + 7) / 8, 0);
+    for (size_t i = 0; i < m_in_region.size(); i++)
+        if (m_in_region[i]) mask[i / 8] |= (uint8_t)(1 << (i % 8));
+    out.write(reinterpret_cast<const char*>(mask.data()), mask.size());
+    out.write(reinterpret_cast<const char*>(m_counts.data()), m_counts.size() * sizeof(uint16_t));
+    return out.good();
+}
+
+bool CoverageGrid::load(const std::string& path) {
+    *this = CoverageGrid();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[sizeof(COVERAGE_MAGIC)];
+    uint32_t version, cols, rows;
+    double min_x, min_y, cell_size;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), COVERAGE_MAGIC))
+        return false;
+    if (!readRaw(in, version) || version != COVERAGE_VERSION) return false;
+    if (!readRaw(in, min_x) || !readRaw(in, min_y) || !readRaw(in, cell_size) ||
+        !readRaw(in, cols) || !readRaw(in, rows))
+        return false;
+    if (cell_size <= 0 || cols == 0 || rows == 0 || (uint64_t)cols * rows > 0x10000000)
+        return false;
+
+    size_t cells = (size_t)cols * rows;
+    std::vector<uint8_t> mask((cells + 7) / 8);
+    std::vector<uint16_t> counts(cells);
+    if (!in.read(reinterpret_cast<char*>(mask.data()), mask.size())) return false;
+    if (!in.read(reinterpret_cast<char*>(counts.data()), cells * sizeof(uint16_t))) return false;
+
+    m_min_x = min_x;
+    m_min_y = min_y;
+    m_cell_size = cell_size;
+    m_cols = cols;
+    m_rows = rows;
+    m_in_region.resize(cells);
+    for (size_t i = 0; i < cells; i++) {
+        m_in_region[i] = (mask[i / 8] >> (i % 8)) & 1;
+        if (!m_in_region[i]) counts[i] = 0;
+        if (m_in_region[i]) m_region_cells++;
+        if (counts[i] > 0) m_cells_visited++;
+    }
+    m_counts.swap(counts);
+    return true;
+}
+
+bool CoverageGrid::writeHeatmap(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    for (unsigned int r = 0; r < m_rows; r++) {
+        unsigned int row = m_rows - 1 - r;
+        for (unsigned int col = 0; col < m_cols; col++) {
+            if (col > 0) out << ",";
+            if (inRegion(col, row)) out << count(col, row);
+            else out << "-1";
+        }
+        out << "\n";
+    }
+    return out.good();
+}
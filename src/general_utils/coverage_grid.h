@@ -0,0 +1,68 @@
+#ifndef COVERAGE_GRID_H
+#define COVERAGE_GRID_H
+
+#include "XYPolygon.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Visit counts on a fixed-resolution grid over a region's bounding box.
+// Cells whose center lies inside the region make up the area being
+// covered. Adding a position sample is O(1), so coverage and heatmaps
+// can be kept for a whole mission without storing trajectories.
+class CoverageGrid {
+  public:
+    CoverageGrid();
+
+    // Lay the grid over poly with square cells of cell_size meters.
+    // Clears all counts. Returns false (and leaves the grid empty) for an
+    // invalid polygon or cell size.
+    bool setRegion(const XYPolygon& poly, double cell_size);
+
+    // Zero the counts, keeping the region
+    void reset();
+
+    // Count a position sample. Returns true if this was the first visit
+    // to a region cell. Samples outside the region are ignored.
+    bool add(double x, double y);
+
+    // Add the counts of another grid laid over the same region, e.g. to
+    // combine vehicles into a team. Returns false if the grids differ.
+    bool merge(const CoverageGrid& other);
+
+    bool empty() const { return m_cols == 0; }
+    unsigned int cols() const { return m_cols; }
+    unsigned int rows() const { return m_rows; }
+    double cellSize() const { return m_cell_size; }
+    unsigned int regionCells() const { return m_region_cells; }
+    unsigned int cellsVisited() const { return m_cells_visited; }
+
+    // Fraction of region cells visited at least once, 0 with no region
+    double coverage() const;
+
+    bool inRegion(unsigned int col, unsigned int row) const { return m_in_region[row * m_cols + col]; }
+    // Counts saturate at 65535
+    uint16_t count(unsigned int col, unsigned int row) const { return m_counts[row * m_cols + col]; }
+
+    // Compact binary form: header, region mask bits, then 16-bit counts
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Counts as CSV, one line per row with the northmost row first.
+    // Cells outside the region are written as -1.
+    bool writeHeatmap(const std::string& path) const;
+
+  private:
+    double m_min_x;
+    double m_min_y;
+    double m_cell_size;
+    unsigned int m_cols;
+    unsigned int m_rows;
+
+    std::vector<uint8_t> m_in_region;
+    std::vector<uint16_t> m_counts;
+    unsigned int m_region_cells;
+    unsigned int m_cells_visited;
+};
+
+#endif // COVERAGE_GRID_H
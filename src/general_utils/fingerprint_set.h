@@ -0,0 +1,66 @@
+#ifndef FINGERPRINT_SET_H
+#define FINGERPRINT_SET_H
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+// 64-bit fingerprint of a string: FNV-1a followed by a murmur3-style
+// finalizer so nearby inputs spread over the whole table
+inline uint64_t fingerprint64(std::string_view str) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : str) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Open-addressing set of 64-bit fingerprints with linear probing. Eight
+// bytes per slot and no per-entry allocation, so it stays far smaller
+// than a set of the strings themselves.
+class FingerprintSet {
+  public:
+    FingerprintSet() : m_slots(1024, 0), m_size(0) {}
+
+    // Returns true if the fingerprint was not already in the set
+    bool insert(uint64_t fp) {
+        if (fp == 0) fp = 1;  // 0 marks an empty slot
+        if ((m_size + 1) * 2 > m_slots.size()) grow();
+        if (!place(m_slots, fp)) return false;
+        m_size++;
+        return true;
+    }
+
+    size_t size() const { return m_size; }
+
+  private:
+    static bool place(std::vector<uint64_t>& slots, uint64_t fp) {
+        size_t mask = slots.size() - 1;
+        for (size_t i = fp & mask;; i = (i + 1) & mask) {
+            if (slots[i] == fp) return false;
+            if (slots[i] == 0) {
+                slots[i] = fp;
+                return true;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<uint64_t> bigger(m_slots.size() * 2, 0);
+        for (uint64_t fp : m_slots)
+            if (fp != 0) place(bigger, fp);
+        m_slots.swap(bigger);
+    }
+
+  private:
+    std::vector<uint64_t> m_slots;  // size is always a power of two
+    size_t m_size;
+};
+
+#endif // FINGERPRINT_SET_H
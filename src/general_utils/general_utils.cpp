@@ -1,9 +1,23 @@
 #include "general_utils.h"
+#include "mapped_file.h"
+#include "fingerprint_set.h"
+#include "position_file.h"
 #include <dirent.h>
 #include <sys/stat.h>
 #include <fstream>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <queue>
+#include <limits>
 #include <algorithm>
 #include <cerrno>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 
 //-------------------------------------------------------------
 // Procedure: calcDeltaHeading(double heading1, double heading2)
@@ -189,128 +203,634 @@ int highestValueInd(std::vector<double> vec) {
   return std::distance(vec.begin(), it);
 }
 
-bool processNodeReports(const std::string& shoreside_log_dir, const std::string& out_dir) {
-  std::ifstream infile(shoreside_log_dir);
-  std::string line;
+// Trim spaces and tabs from both ends of a view
+static std::string_view trimView(std::string_view str) {
+  while (!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+    str.remove_prefix(1);
+  while (!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+    str.remove_suffix(1);
+  return str;
+}
+
+bool parseDoubleView(std::string_view str, double& val) {
+  str = trimView(str);
+  if (!str.empty() && str.front() == '+')
+    str.remove_prefix(1);
+
+  // from_chars also accepts inf/nan, which setDoubleOnString never did
+  size_t i = (!str.empty() && str.front() == '-') ? 1 : 0;
+  if (i >= str.size() || (!isdigit((unsigned char)str[i]) && str[i] != '.'))
+    return false;
+
+  const char* end = str.data() + str.size();
+  std::from_chars_result res = std::from_chars(str.data(), end, val);
+  return (res.ec == std::errc() && res.ptr == end);
+}
 
-  // Set to track seen names
-  std::unordered_set<std::string> seen_names;
+bool scanNodeReport(std::string_view report, NodeReportFields& fields) {
+  fields = NodeReportFields();
+  bool has_name = false;
+
+  size_t pos = 0;
+  while (pos < report.size()) {
+    size_t comma = report.find(',', pos);
+    if (comma == std::string_view::npos)
+      comma = report.size();
+
+    std::string_view part = report.substr(pos, comma - pos);
+    pos = comma + 1;
+
+    size_t eq = part.find('=');
+    if (eq == std::string_view::npos)
+      continue;
+
+    std::string_view key = trimView(part.substr(0, eq));
+    std::string_view val = trimView(part.substr(eq + 1));
+    if (key == "NAME") {
+      fields.name = val;
+      has_name = true;
+    } else if (key == "X") {
+      fields.x_str = val;
+      fields.has_x = parseDoubleView(val, fields.x);
+    } else if (key == "Y") {
+      fields.y_str = val;
+      fields.has_y = parseDoubleView(val, fields.y);
+    } else if (key == "HDG") {
+      fields.hdg_str = val;
+      fields.has_hdg = parseDoubleView(val, fields.hdg);
+    } else if (key == "SPD") {
+      fields.spd_str = val;
+      fields.has_spd = parseDoubleView(val, fields.spd);
+    } else if (key == "TIME") {
+      fields.time_str = val;
+      fields.has_time = parseDoubleView(val, fields.time);
+    } else {
+      continue;
+    }
 
-  // Regex pattern to match NAME, X, and Y
-  std::regex pattern(R"(NAME=([^,]+),X=([^,]+),Y=([^,]+))");
+    // Everything we care about has been seen, skip the rest
+    if (has_name && !fields.x_str.empty() && !fields.y_str.empty() && !fields.hdg_str.empty() &&
+        !fields.spd_str.empty() && !fields.time_str.empty())
+      break;
+  }
+
+  return !fields.name.empty();
+}
+
+// Split an alog line "<time> <var> <source> <value>" into time, var and value
+static bool splitAlogLine(std::string_view line, std::string_view& time, std::string_view& var,
+                          std::string_view& value) {
+  std::string_view fields[3];
+  size_t pos = 0;
+  for (int i = 0; i < 3; i++) {
+    while (pos < line.size() && isspace((unsigned char)line[pos])) pos++;
+    size_t start = pos;
+    while (pos < line.size() && !isspace((unsigned char)line[pos])) pos++;
+    if (start == pos)
+      return false;
+    fields[i] = line.substr(start, pos - start);
+  }
+  while (pos < line.size() && isspace((unsigned char)line[pos])) pos++;
+
+  time = fields[0];
+  var = fields[1];
+  value = line.substr(pos);
+  return true;
+}
+
+// Output files for one vehicle, kept open for the whole conversion. CSV
+// rows collect in buffer and are written out in large blocks.
+struct PositionWriter {
+  std::ofstream file;
+  std::string buffer;
+  std::unique_ptr<PositionFileWriter> binary;
+};
+
+static const size_t POSITION_WRITE_BLOCK = 1 << 16;
+
+static bool flushPositionWriter(PositionWriter& writer) {
+  writer.file.write(writer.buffer.data(), writer.buffer.size());
+  writer.buffer.clear();
+  return writer.file.good();
+}
+
+// Trim trailing periods
+// (They are sometimes left over as artifacts in the logged report)
+static std::string_view trimTrailingPeriods(std::string_view str) {
+  while (!str.empty() && str.back() == '.') str.remove_suffix(1);
+  return str;
+}
+
+bool processNodeReports(const std::string& shoreside_log_dir, const std::string& out_dir,
+                        bool write_binary) {
+  // Scan the log in place rather than copying it out line by line
+  MappedFile log;
+  if (!log.open(shoreside_log_dir)) {
+    std::cerr << "Failed to open log: " << shoreside_log_dir << std::endl;
+    return false;
+  }
+  std::string_view text = log.view();
+
+  // One writer per vehicle name
+  std::unordered_map<std::string, PositionWriter> writers;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(pos, end - pos);
+    pos = end + 1;
 
-  while (std::getline(infile, line)) {
     // Ignore empty lines and lines that start with %
     if (line.empty() || line[0] == '%') continue;
 
-    std::smatch match;
-    if (std::regex_search(line, match, pattern)) {
-      std::string name = match[1];
-      std::string x_str = match[2];
-      std::string y_str = match[3];
-
-      // Trim trailing periods
-      // (They are sometimes left over as artifacts from the first regex)
-      x_str = std::regex_replace(x_str, std::regex(R"(\.+$)"), "");
-      y_str = std::regex_replace(y_str, std::regex(R"(\.+$)"), "");
-
-      // Validate that x_str and y_str can be converted to doubles
-      double x_val, y_val;
-      if (!setDoubleOnString(x_val, x_str) || !setDoubleOnString(y_val, y_str)) {
-        // Skip this entry if either x or y is not a valid double
-        continue;
-      }
+    std::string_view time_str, var, value;
+    if (!splitAlogLine(line, time_str, var, value)) continue;
+    if (var != "NODE_REPORT") continue;
 
-      // Check if the name has been seen before
-      if (seen_names.find(name) == seen_names.end()) {
-        // Add the name to the set
-        seen_names.insert(name);
+    NodeReportFields fields;
+    if (!scanNodeReport(value, fields)) continue;
 
-        // Create a new file for this name
-        std::string file_path = out_dir + "/" + name + "_positions.csv";
-        std::ofstream outfile(file_path);
+    std::string_view x_str = trimTrailingPeriods(fields.x_str);
+    std::string_view y_str = trimTrailingPeriods(fields.y_str);
+    std::string_view hdg_str = trimTrailingPeriods(fields.hdg_str);
+    std::string_view spd_str = trimTrailingPeriods(fields.spd_str);
 
-        // Stop if we can't open the output file
-        if (!outfile.is_open()) {
-          std::cerr << "Failed to create file: " << file_path << std::endl;
-          return false;
-        }
+    // Validate that time, x_str and y_str can be converted to doubles
+    double time, x_val, y_val;
+    if (!parseDoubleView(time_str, time) || !parseDoubleView(x_str, x_val) ||
+        !parseDoubleView(y_str, y_val)) {
+      // Skip this entry if any of them is not a valid double
+      continue;
+    }
 
-        // Write the header to the new file
-        outfile << "x,y\n";
-        outfile.close();
-      }
+    // Heading and speed are optional, leave the column empty if invalid
+    double hdg_val = nan, spd_val = nan;
+    if (!parseDoubleView(hdg_str, hdg_val)) {
+      hdg_str = std::string_view();
+      hdg_val = nan;
+    }
+    if (!parseDoubleView(spd_str, spd_val)) {
+      spd_str = std::string_view();
+      spd_val = nan;
+    }
 
-      // Append the x,y positions to the corresponding file
-      std::ofstream outfile(out_dir + "/" + name + "_positions.csv", std::ios::app);
-      if (!outfile.is_open()) {
-        std::cerr << "Failed to open file: " << out_dir + "/" + name + "_positions.csv" << std::endl;
+    std::string name(fields.name);
+    std::unordered_map<std::string, PositionWriter>::iterator it = writers.find(name);
+    if (it == writers.end()) {
+      // Create new files for this name
+      std::string file_path = out_dir + "/" + name + "_positions.csv";
+      it = writers.emplace(name, PositionWriter()).first;
+      it->second.file.open(file_path, std::ios::binary | std::ios::trunc);
+
+      // Stop if we can't open the output file
+      if (!it->second.file.is_open()) {
+        std::cerr << "Failed to create file: " << file_path << std::endl;
         return false;
       }
-      outfile << x_str << "," << y_str << "\n";
-      outfile.close();
+
+      // Write the header to the new file
+      it->second.buffer = "time,x,y,hdg,spd\n";
+
+      if (write_binary) {
+        std::string bin_path = out_dir + "/" + name + "_positions.bin";
+        it->second.binary.reset(new PositionFileWriter);
+        if (!it->second.binary->open(bin_path)) {
+          std::cerr << "Failed to create file: " << bin_path << std::endl;
+          return false;
+        }
+      }
+    }
+
+    // Append the row to the corresponding files
+    PositionWriter& writer = it->second;
+    writer.buffer.append(time_str).append(",").append(x_str).append(",").append(y_str)
+        .append(",").append(hdg_str).append(",").append(spd_str).append("\n");
+    if (writer.binary)
+      writer.binary->append({time, x_val, y_val, hdg_val, spd_val});
+    if (writer.buffer.size() >= POSITION_WRITE_BLOCK && !flushPositionWriter(writer)) {
+      std::cerr << "Failed to write file: " << out_dir + "/" + name + "_positions.csv" << std::endl;
+      return false;
     }
   }
 
+  for (std::pair<const std::string, PositionWriter>& entry : writers) {
+    if (!flushPositionWriter(entry.second)) {
+      std::cerr << "Failed to write file: " << out_dir + "/" + entry.first + "_positions.csv" << std::endl;
+      return false;
+    }
+    if (entry.second.binary && !entry.second.binary->close()) {
+      std::cerr << "Failed to write file: " << out_dir + "/" + entry.first + "_positions.bin" << std::endl;
+      return false;
+    }
+  }
   return true;
 }
 
+// Name of the file recording which alog an output directory was made from
+static const char NODE_REPORT_STAMP[] = ".node_reports_stamp";
+
+// Layout of the files processNodeReports writes. Bump it whenever that
+// changes, so outputs from an older build are converted again.
+//   1: x,y
+//   2: time,x,y,hdg,spd
+static const int NODE_REPORT_FORMAT = 2;
+
+// Output format, size and modification time of a file, plus the output
+// options, as written to the stamp file
+static std::string alogStamp(const std::string& alog, bool binary) {
+  std::error_code ec;
+  uintmax_t size = std::filesystem::file_size(alog, ec);
+  if (ec) return "";
+  std::filesystem::file_time_type mtime = std::filesystem::last_write_time(alog, ec);
+  if (ec) return "";
+  return "fmt=" + std::to_string(NODE_REPORT_FORMAT) +
+         ",size=" + std::to_string(size) +
+         ",mtime=" + std::to_string(mtime.time_since_epoch().count()) +
+         (binary ? ",binary=1" : "");
+}
+
+std::vector<NodeReportJob> findNodeReportJobs(const std::string& path) {
+  std::vector<NodeReportJob> jobs;
+  std::error_code ec;
+
+  std::vector<std::string> alogs;
+  if (std::filesystem::is_regular_file(path, ec)) {
+    alogs.push_back(path);
+  }
+  else if (std::filesystem::is_directory(path, ec)) {
+    std::filesystem::recursive_directory_iterator it(path, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+      if (!it->is_regular_file(ec)) continue;
+      std::string name = it->path().filename().string();
+      if (strEnds(name, ".alog") && strContains(toupper(name), "SHORESIDE"))
+        alogs.push_back(it->path().string());
+    }
+  }
+  std::sort(alogs.begin(), alogs.end());
+
+  for (const std::string& alog : alogs) {
+    NodeReportJob job;
+    job.alog = alog;
+    job.out_dir = (std::filesystem::path(alog).parent_path() / "positions").string();
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+
+// Convert one alog unless its output is already up to date
+static void runNodeReportJob(NodeReportJob& job, bool force) {
+  std::string stamp = alogStamp(job.alog, job.binary);
+  std::string stamp_path = job.out_dir + "/" + NODE_REPORT_STAMP;
+  std::error_code ec;
+  job.bytes = std::filesystem::file_size(job.alog, ec);
+
+  if (!force && stamp != "") {
+    std::ifstream in(stamp_path);
+    std::string old_stamp;
+    if (std::getline(in, old_stamp) && old_stamp == stamp) {
+      job.skipped = true;
+      job.ok = true;
+      return;
+    }
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::filesystem::create_directories(job.out_dir, ec);
+  // Drop the old stamp first: if this run fails partway the outputs are
+  // truncated, and a stamp left behind would make later runs skip them
+  std::filesystem::remove(stamp_path, ec);
+  job.ok = processNodeReports(job.alog, job.out_dir, job.binary);
+  job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Only stamp complete conversions, so a failed one is retried next time
+  if (job.ok && stamp != "") {
+    std::ofstream out(stamp_path);
+    out << stamp << "\n";
+  }
+}
+
+bool processNodeReportJobs(std::vector<NodeReportJob>& jobs, unsigned int num_threads, bool force,
+                           const std::function<void(const NodeReportJob&)>& on_done) {
+  if (num_threads == 0) num_threads = 1;
+  num_threads = std::min<size_t>(num_threads, std::max<size_t>(jobs.size(), 1));
+
+  std::atomic<size_t> next_job(0);
+  std::mutex done_mutex;
+  auto worker = [&]() {
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      runNodeReportJob(jobs[i], force);
+      if (on_done) {
+        std::lock_guard<std::mutex> lock(done_mutex);
+        on_done(jobs[i]);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < num_threads; i++) threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads) thread.join();
+
+  for (const NodeReportJob& job : jobs)
+    if (!job.ok) return false;
+  return true;
+}
+
+// Strip the whitespace stripBlankEnds() would, without copying
+static std::string_view stripBlankEndsView(std::string_view str) {
+  const char* blanks = " \t\r\n";
+  size_t first = str.find_first_not_of(blanks);
+  if (first == std::string_view::npos) return std::string_view();
+  size_t last = str.find_last_not_of(blanks);
+  return str.substr(first, last - first + 1);
+}
+
+// Files are compared this many bytes at a time
+static const size_t CSV_COMPARE_BLOCK = 1 << 16;
+
+// Drop one final newline, so a file missing it still matches, the same
+// as when the files were compared line by line
+static std::string_view withoutFinalNewline(std::string_view text) {
+  if (!text.empty() && text.back() == '\n') text.remove_suffix(1);
+  return text;
+}
+
+// Offset of the first byte where a and b differ (or the length of the
+// shorter one). Whole blocks are compared with memcmp and only a block
+// that differs is scanned byte by byte.
+static size_t firstDifference(std::string_view a, std::string_view b) {
+  size_t n = std::min(a.size(), b.size());
+  size_t pos = 0;
+  while (pos < n) {
+    size_t len = std::min(CSV_COMPARE_BLOCK, n - pos);
+    if (std::memcmp(a.data() + pos, b.data() + pos, len) != 0) break;
+    pos += len;
+  }
+  while (pos < n && a[pos] == b[pos]) pos++;
+  return pos;
+}
+
+// The line of text holding offset pos
+static std::string_view lineAround(std::string_view text, size_t pos) {
+  size_t start = (pos == 0) ? 0 : text.rfind('\n', pos - 1);
+  start = (start == std::string_view::npos || pos == 0) ? 0 : start + 1;
+  size_t end = text.find('\n', pos);
+  if (end == std::string_view::npos) end = text.size();
+  return text.substr(start, end - start);
+}
+
 // Check if two csv files have exactly the same contents
 bool csvFilesAreEqual(const std::string& file1, const std::string& file2, int verbose) {
-  std::ifstream f1(file1), f2(file2);
-  if (!f1.is_open() || !f2.is_open())
+  MappedFile f1, f2;
+  if (!f1.open(file1) || !f2.open(file2))
     return false;
 
-  std::string line1, line2;
+  std::string_view text1 = withoutFinalNewline(f1.view());
+  std::string_view text2 = withoutFinalNewline(f2.view());
+
+  // Files of different sizes can't match, so don't read them unless we
+  // need to say where they differ
+  if (text1.size() != text2.size() && verbose <= 0)
+    return false;
+
+  size_t diff = firstDifference(text1, text2);
+  if (diff == text1.size() && diff == text2.size()) {
+    // both files ended
+    if (verbose > 0) std::cout << "Csv files "<<file1<<" and "<<file2<<" are equal." << std::endl;
+    return true;
+  }
+
+  if (verbose > 0) {
+    std::string_view longer = (text1.size() > text2.size()) ? text1 : text2;
+    size_t line_num = std::count(text1.begin(), text1.begin() + diff, '\n') + 1;
+    if (diff == std::min(text1.size(), text2.size()) && longer[diff] == '\n') {
+      // one file ended before the other
+      std::cout << "Between csv files "<<file1<<" and "<<file2<<", one file ended before the other"
+                << " (after line " << line_num << ")." << std::endl;
+    } else {
+      // lines differ
+      std::cout << "Different lines found between files "<<file1<<" and "<<file2<<" at line "<<line_num
+                << ". Lines "<<lineAround(text1, diff)<<" and "<<lineAround(text2, diff)
+                << " differ, respectively." << std::endl;
+    }
+  }
+  return false;
+}
+
+// Compare one row field by field, numbers within tolerance
+static bool csvRowsAreClose(std::string_view row1, std::string_view row2,
+                            double rel_tol, double abs_tol) {
   while (true) {
-    bool read1 = static_cast<bool>(std::getline(f1, line1));
-    bool read2 = static_cast<bool>(std::getline(f2, line2));
-    if (!read1 && !read2) {
-      // both files ended
-      if (verbose > 0) std::cout << "Csv files "<<file1<<" and "<<file2<<" are equal." << std::endl;
-      return true;
+    size_t comma1 = row1.find(',');
+    size_t comma2 = row2.find(',');
+    std::string_view field1 = trimView(row1.substr(0, comma1));
+    std::string_view field2 = trimView(row2.substr(0, comma2));
+    double val1, val2;
+    if (parseDoubleView(field1, val1) && parseDoubleView(field2, val2)) {
+      if (!isClose(val1, val2, rel_tol, abs_tol)) return false;
+    } else if (field1 != field2) {
+      return false;
     }
-    if (read1 != read2) {
-      // one file ended before the other
-      if (verbose > 0) std::cout << "Between csv files "<<file1<<" and "<<file2<<", one file ended before the other." << std::endl;
+
+    if (comma1 == std::string_view::npos || comma2 == std::string_view::npos)
+      return (comma1 == comma2);
+    row1.remove_prefix(comma1 + 1);
+    row2.remove_prefix(comma2 + 1);
+  }
+}
+
+bool csvFilesAreClose(const std::string& file1, const std::string& file2,
+                      double rel_tol, double abs_tol, int verbose) {
+  // Identical files are the common case and need no parsing
+  if (csvFilesAreEqual(file1, file2))
+    return true;
+
+  MappedFile f1, f2;
+  if (!f1.open(file1) || !f2.open(file2))
+    return false;
+
+  std::string_view text1 = withoutFinalNewline(f1.view());
+  std::string_view text2 = withoutFinalNewline(f2.view());
+  // A view that becomes empty after a newline still has an empty last line
+  bool done1 = text1.empty(), done2 = text2.empty();
+  size_t line_num = 0;
+  while (!done1 || !done2) {
+    line_num++;
+    if (done1 != done2) {
+      if (verbose > 0) std::cout << "Between csv files "<<file1<<" and "<<file2<<", one file ended before the other"
+                                 << " (after line " << line_num - 1 << ")." << std::endl;
       return false;
     }
-    if (line1 != line2) {
-      // lines differ
-      if (verbose > 0) std::cout << "Different lines found between files "<<file1<<" and "<<file2<<". Lines "<<line1<<" and "<<line2<<" differ, respectively." << std::endl;
+
+    size_t end1 = std::min(text1.find('\n'), text1.size());
+    size_t end2 = std::min(text2.find('\n'), text2.size());
+    std::string_view row1 = stripBlankEndsView(text1.substr(0, end1));
+    std::string_view row2 = stripBlankEndsView(text2.substr(0, end2));
+    done1 = (end1 == text1.size());
+    done2 = (end2 == text2.size());
+    text1.remove_prefix(std::min(end1 + 1, text1.size()));
+    text2.remove_prefix(std::min(end2 + 1, text2.size()));
+
+    if (!csvRowsAreClose(row1, row2, rel_tol, abs_tol)) {
+      if (verbose > 0) std::cout << "Different lines found between files "<<file1<<" and "<<file2<<" at line "<<line_num
+                                 << ". Lines "<<row1<<" and "<<row2<<" differ, respectively." << std::endl;
       return false;
     }
   }
+
+  if (verbose > 0) std::cout << "Csv files "<<file1<<" and "<<file2<<" are equal within tolerance." << std::endl;
+  return true;
 }
 
 // Take in a csv and output a csv with no duplicate rows
-bool csvFilterDuplicateRows(const std::string& in_csv, const std::string& out_csv, int verbose) {
-    std::ifstream infile(in_csv);
-    if (!infile.is_open()) {
+bool csvFilterDuplicateRows(const std::string& in_csv, const std::string& out_csv, int verbose,
+                            DuplicateFilterMode mode) {
+    MappedFile infile;
+    if (!infile.open(in_csv)) {
         if (verbose > 0) std::cout << "Failed to open input CSV: " << in_csv << std::endl;
         return false;
     }
 
-    std::ofstream outfile(out_csv);
+    // Truncating the input while it is mapped would pull the rows out
+    // from under us
+    std::error_code ec;
+    if (std::filesystem::equivalent(in_csv, out_csv, ec)) {
+        if (verbose > 0) std::cout << "Input and output CSV are the same file: " << in_csv << std::endl;
+        return false;
+    }
+
+    std::ofstream outfile(out_csv, std::ios::binary);
     if (!outfile.is_open()) {
         if (verbose > 0) std::cout << "Failed to open output CSV: " << out_csv << std::endl;
         return false;
     }
 
-    std::unordered_set<std::string> seen_rows;
-    std::string line;
-
-    while (std::getline(infile, line)) {
-        if (seen_rows.insert(line).second) {  // Only insert if not already seen
-            outfile << line << '\n';
+    // Rows are views into the mapped file, so even the exact mode only
+    // stores the set itself
+    std::unordered_set<std::string_view> seen_rows;
+    FingerprintSet seen_fingerprints;
+    std::string_view prev_row;
+    bool have_prev = false;
+
+    std::string buffer;
+    std::string_view text = infile.view();
+    size_t pos = 0;
+    size_t rows_in = 0, rows_out = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        rows_in++;
+
+        bool keep = false;
+        if (mode == DuplicateFilterMode::Exact)
+            keep = seen_rows.insert(line).second;  // Only insert if not already seen
+        else if (mode == DuplicateFilterMode::Fingerprint)
+            keep = seen_fingerprints.insert(fingerprint64(line));
+        else
+            keep = !have_prev || (line != prev_row);
+        prev_row = line;
+        have_prev = true;
+
+        if (keep) {
+            buffer.append(line).push_back('\n');
+            rows_out++;
+            if (buffer.size() >= (1 << 16)) {
+                outfile.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
         }
     }
+    outfile.write(buffer.data(), buffer.size());
 
-    return true;
+    if (verbose > 0) std::cout << "Kept " << rows_out << " of " << rows_in << " rows" << std::endl;
+    return outfile.good();
 }
 
+// The col'th comma separated field of a row, or empty if there is none
+static std::string_view csvField(std::string_view row, int col) {
+  for (int i = 0; i < col; i++) {
+    size_t comma = row.find(',');
+    if (comma == std::string_view::npos) return std::string_view();
+    row.remove_prefix(comma + 1);
+  }
+  return row.substr(0, row.find(','));
+}
+
+// Index of a column in a header row, or -1
+static int csvColumnIndex(std::string_view header, std::string_view name) {
+  for (int col = 0;; col++) {
+    size_t comma = header.find(',');
+    if (trimView(header.substr(0, comma)) == name) return col;
+    if (comma == std::string_view::npos) return -1;
+    header.remove_prefix(comma + 1);
+  }
+}
+
+// Non-empty, blank-stripped rows of a mapped csv file. A leading row that
+// is not all numbers is held back as the header. Pages already read are
+// released every CSV_RELEASE_BLOCK bytes, so a reader holds about that
+// much of its file in memory however large it is.
+static const size_t CSV_RELEASE_BLOCK = 1 << 20;
+
+class CsvRowReader {
+  public:
+    bool open(const std::string& path) {
+      if (!m_file.open(path)) return false;
+      m_text = m_file.view();
+      std::string_view first;
+      if (next(first)) {
+        if (isHeaderRow(first)) m_header = first;
+        else m_pending = first;
+      }
+      return true;
+    }
+
+    std::string_view header() const { return m_header; }
+
+    bool next(std::string_view& row) {
+      if (!m_pending.empty()) {
+        row = m_pending;
+        m_pending = std::string_view();
+        return true;
+      }
+      while (!m_text.empty()) {
+        size_t end = m_text.find('\n');
+        if (end == std::string_view::npos) end = m_text.size();
+        row = stripBlankEndsView(m_text.substr(0, end));
+        m_text.remove_prefix(std::min(end + 1, m_text.size()));
+        if (!row.empty()) {
+          size_t offset = row.data() - m_file.data();
+          if (offset - m_file.released() >= CSV_RELEASE_BLOCK) m_file.release(offset);
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    static bool isHeaderRow(std::string_view row) {
+      double val;
+      while (true) {
+        size_t comma = row.find(',');
+        if (!parseDoubleView(trimView(row.substr(0, comma)), val)) return true;
+        if (comma == std::string_view::npos) return false;
+        row.remove_prefix(comma + 1);
+      }
+    }
+
+    MappedFile m_file;
+    std::string_view m_text;
+    std::string_view m_header;
+    std::string_view m_pending;
+};
+
 // Merge all *_positions.csv in `directory` (excluding team_positions.csv) into team_positions.csv
-bool csvMergeFiles(const std::string& directory, const std::vector<std::string>& exclude_vehicles) {
+bool csvMergeFiles(const std::string& directory, const std::vector<std::string>& exclude_vehicles,
+                   bool merge_by_time) {
   // Validate directory
   struct stat st;
   if (stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
@@ -360,27 +880,39 @@ bool csvMergeFiles(const std::string& directory, const std::vector<std::string>&
 
   std::sort(files.begin(), files.end()); // deterministic order
 
-  // Read and merge rows (skip header if exactly "x,y")
-  std::vector<std::string> merged_rows;
-  for (const std::string& fname : files) {
-    std::ifstream in(directory + "/" + fname);
-    if (!in.is_open()) {
-      std::cerr << "csvMergeFiles(): Failed to open " << (directory + "/" + fname) << std::endl;
+  // Stream every file rather than holding rows in memory
+  std::vector<CsvRowReader> readers(files.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    if (!readers[i].open(directory + "/" + files[i])) {
+      std::cerr << "csvMergeFiles(): Failed to open " << (directory + "/" + files[i]) << std::endl;
       return false;
     }
-    std::string line;
-    bool first = true;
-    while (std::getline(in, line)) {
-      std::string s = stripBlankEnds(line);
-      if (s.empty()) continue;
+  }
 
-      if (first) {
-        first = false;
-        if (s == "x,y") continue; // skip header
-      }
-      merged_rows.push_back(s);
+  // The first row of a file is a header if it is not all numbers. Files
+  // with headers must agree, files without one get "x,y".
+  std::string_view header;
+  size_t header_file = 0;
+  for (size_t i = 0; i < readers.size(); i++) {
+    std::string_view file_header = readers[i].header();
+    if (file_header.empty()) continue;
+    if (header.empty()) {
+      header = file_header;
+      header_file = i;
+    }
+    else if (file_header != header) {
+      std::cerr << "csvMergeFiles(): Header of " << files[i] << " (" << file_header
+                << ") does not match " << files[header_file] << " (" << header << ")" << std::endl;
+      return false;
     }
   }
+  if (header.empty()) header = "x,y";
+
+  int time_col = csvColumnIndex(header, "time");
+  if (merge_by_time && time_col < 0) {
+    std::cerr << "csvMergeFiles(): No time column to merge by in header: " << header << std::endl;
+    return false;
+  }
 
   // Write output
   std::string out_path;
@@ -394,14 +926,52 @@ bool csvMergeFiles(const std::string& directory, const std::vector<std::string>&
     out_path += ".csv";
   }
 
-  std::ofstream out(out_path, std::ios::trunc);
+  std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
   if (!out.is_open()) {
     std::cerr << "csvMergeFiles(): Failed to open output file: " << out_path << std::endl;
     return false;
   }
-  out << "x,y\n";
-  for (const auto& row : merged_rows)
-    out << row << "\n";
 
-  return true;
+  std::string buffer(header);
+  buffer.push_back('\n');
+  auto writeRow = [&](std::string_view row) {
+    buffer.append(row).push_back('\n');
+    if (buffer.size() >= (1 << 16)) {
+      out.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  };
+
+  std::string_view row;
+  if (!merge_by_time) {
+    // One file after another, as listed
+    for (CsvRowReader& reader : readers)
+      while (reader.next(row)) writeRow(row);
+  }
+  else {
+    // K-way merge on the time column. Ties go to the earlier file, and a
+    // row whose time can't be read keeps the time of the row before it.
+    typedef std::pair<double, size_t> HeapEntry;  // (time, reader)
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    std::vector<std::string_view> current(readers.size());
+    std::vector<double> last_time(readers.size(), -std::numeric_limits<double>::infinity());
+
+    auto advance = [&](size_t i) {
+      if (!readers[i].next(current[i])) return;
+      double time;
+      if (parseDoubleView(trimView(csvField(current[i], time_col)), time)) last_time[i] = time;
+      heap.push(HeapEntry(last_time[i], i));
+    };
+    for (size_t i = 0; i < readers.size(); i++) advance(i);
+
+    while (!heap.empty()) {
+      size_t i = heap.top().second;
+      heap.pop();
+      writeRow(current[i]);
+      advance(i);
+    }
+  }
+
+  out.write(buffer.data(), buffer.size());
+  return out.good();
 }
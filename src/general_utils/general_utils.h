@@ -11,6 +11,8 @@
 #include <regex>
 #include <filesystem>
 #include <unordered_set>
+#include <string_view>
+#include <functional>
 
 //-------------------------------------------------------------
 // Procedure: calcDeltaHeading(double heading1, double heading2)
@@ -55,16 +57,100 @@ double XYToRelAngle(XYPoint point);
 // Get the index of the highest value in the vector
 int highestValueInd(std::vector<double> vec);
 
-// Turn node reports into a csv file for easy processing
-bool processNodeReports(const std::string& shoreside_log_dir, const std::string& out_dir);
-
-// Check if two csv files have exactly the same contents
+// Fields of interest in a NODE_REPORT string. The views point into the
+// scanned report and are only valid while that string is alive.
+struct NodeReportFields {
+  std::string_view name;
+  std::string_view x_str;
+  std::string_view y_str;
+  std::string_view hdg_str;
+  std::string_view spd_str;
+  std::string_view time_str;
+  double x = 0.0;
+  double y = 0.0;
+  double hdg = 0.0;
+  double spd = 0.0;
+  double time = 0.0;    // the TIME the vehicle stamped the report with
+  bool has_x = false;
+  bool has_y = false;
+  bool has_hdg = false;
+  bool has_spd = false;
+  bool has_time = false;
+};
+
+// Parse an entire string_view as a double, rejecting trailing junk
+bool parseDoubleView(std::string_view str, double& val);
+
+// Pull NAME/X/Y/HDG/SPD/TIME out of a NODE_REPORT in a single pass with no heap
+// allocation. Returns true if a NAME was found.
+bool scanNodeReport(std::string_view report, NodeReportFields& fields);
+
+// Turn the node reports in an alog into one <name>_positions.csv per
+// vehicle in out_dir, with columns time,x,y,hdg,spd (time is the alog
+// time; hdg and spd are empty when missing). With write_binary set, a
+// <name>_positions.bin twin is written too (see position_file.h). The
+// log is memory-mapped and scanned in one pass.
+bool processNodeReports(const std::string& shoreside_log_dir, const std::string& out_dir,
+                        bool write_binary = false);
+
+// One alog to convert with processNodeReports() as part of a batch
+struct NodeReportJob {
+  std::string alog;
+  std::string out_dir;
+  bool binary = false;     // also write the binary twins
+  bool ok = false;
+  bool skipped = false;    // out_dir was already up to date
+  uintmax_t bytes = 0;     // size of the alog
+  double seconds = 0;      // time spent converting
+};
+
+// Find the shoreside alogs (*SHORESIDE*.alog) under a directory, or take
+// path itself if it is a file. Each job writes to a "positions" directory
+// next to its alog. Results are sorted by alog path.
+std::vector<NodeReportJob> findNodeReportJobs(const std::string& path);
+
+// Run the jobs across up to num_threads threads. A job is skipped when
+// its out_dir holds a stamp matching the alog's current size and mtime,
+// unless force is set. on_done (if given) is called once per job as it
+// finishes, one call at a time. Returns true if every job succeeded.
+bool processNodeReportJobs(std::vector<NodeReportJob>& jobs, unsigned int num_threads,
+                           bool force = false,
+                           const std::function<void(const NodeReportJob&)>& on_done = nullptr);
+
+// Check if two csv files have exactly the same contents (a missing final
+// newline is ignored). Sizes are checked first and the contents compared
+// in large blocks; the differing line is only located when verbose.
 bool csvFilesAreEqual(const std::string& file1, const std::string& file2, int verbose = 0);
 
-// Take in a csv and output a csv with no duplicate rows
-bool csvFilterDuplicateRows(const std::string& in_csv, const std::string& out_csv, int verbose = 0);
-
-// Merge all *_positions.csv files in a directory into team_positions.csv
-bool csvMergeFiles(const std::string& directory, const std::vector<std::string>& exclude_vehicles = {});
+// Like csvFilesAreEqual(), but fields that parse as numbers in both files
+// only need to be isClose() within the given tolerances. Other fields must
+// match exactly, ignoring surrounding blanks.
+bool csvFilesAreClose(const std::string& file1, const std::string& file2,
+                      double rel_tol = 1e-9, double abs_tol = 0.0, int verbose = 0);
+
+// How csvFilterDuplicateRows() decides a row is a duplicate
+enum class DuplicateFilterMode {
+  Exact,        // any earlier identical row, remembered in full
+  Fingerprint,  // any earlier row with the same 64-bit hash (8 bytes per
+                // distinct row, a collision could drop a unique row but
+                // is vanishingly unlikely)
+  Consecutive   // only the row right before it, O(1) memory
+};
+
+// Take in a csv and output a csv with no duplicate rows, keeping the first
+// occurrence of each row in order
+bool csvFilterDuplicateRows(const std::string& in_csv, const std::string& out_csv, int verbose = 0,
+                            DuplicateFilterMode mode = DuplicateFilterMode::Exact);
+
+// Merge all *_positions.csv files in a directory into team_positions.csv.
+// Files are streamed: each one is mapped, but only about the last 1 MiB
+// read of it is kept in memory, so memory use is about 1 MiB per file
+// plus a 64 KiB output buffer, whatever the file sizes. A first
+// row that is not all numbers is taken as the header, and every file's
+// header must match. By default files are appended one after another in
+// name order. With merge_by_time, rows are interleaved by their "time"
+// column, which then has to exist.
+bool csvMergeFiles(const std::string& directory, const std::vector<std::string>& exclude_vehicles = {},
+                   bool merge_by_time = false);
 
 #endif // GENERAL_UTILS_H
@@ -0,0 +1,54 @@
+#include "mapped_file.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap rejects a zero length, an empty file is just an empty view
+    if (st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        // Logs are read front to back once
+        madvise(addr, st.st_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(addr);
+        m_size = st.st_size;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    m_open = true;
+    return true;
+}
+
+void MappedFile::release(size_t offset) {
+    if (!m_data) return;
+    static const size_t page = sysconf(_SC_PAGESIZE);
+    size_t end = std::min(offset, m_size) / page * page;
+    if (end <= m_released) return;
+    madvise(const_cast<char*>(m_data) + m_released, end - m_released, MADV_DONTNEED);
+    m_released = end;
+}
+
+void MappedFile::close() {
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_released = 0;
+    m_open = false;
+}
@@ -0,0 +1,41 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+// Read-only memory map of a whole file, unmapped when this goes out of
+// scope. Lets large logs be scanned in place without copying each line.
+class MappedFile {
+  public:
+    MappedFile() {}
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file, replacing any previous mapping. An empty file opens
+    // fine and maps to an empty view.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    // Drop the pages wholly before offset from memory, for a file read
+    // front to back. Touching them again reads them back from the file,
+    // so views into them stay valid.
+    void release(size_t offset);
+    size_t released() const { return m_released; }
+
+  private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_released = 0;
+    bool m_open = false;
+};
+
+#endif // MAPPED_FILE_H
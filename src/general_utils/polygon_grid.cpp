@@ -0,0 +1,192 @@
+#include "polygon_grid.h"
+#include <cmath>
+#include <algorithm>
+
+PolygonGrid::PolygonGrid()
+{
+    clear();
+}
+
+void PolygonGrid::clear()
+{
+    m_xs.clear();
+    m_ys.clear();
+    m_offset = 0;
+    m_offset_sq = 0;
+    m_min_x = 0;
+    m_min_y = 0;
+    m_cell_size = 1;
+    m_cols = 0;
+    m_rows = 0;
+    m_center_in_poly.clear();
+    m_center_in_region.clear();
+    m_edge_start.clear();
+    m_edges.clear();
+}
+
+bool PolygonGrid::build(const XYPolygon& poly, double offset, unsigned int cells)
+{
+    std::vector<double> xs, ys;
+    for (unsigned int i = 0; i < poly.size(); i++) {
+        xs.push_back(poly.get_vx(i));
+        ys.push_back(poly.get_vy(i));
+    }
+    return build(xs, ys, offset, cells);
+}
+
+bool PolygonGrid::build(const std::vector<double>& xs, const std::vector<double>& ys,
+                        double offset, unsigned int cells)
+{
+    clear();
+    if (xs.size() < 3 || xs.size() != ys.size()) return false;
+    if (cells == 0) cells = 1;
+
+    m_xs = xs;
+    m_ys = ys;
+    m_offset = std::max(offset, 0.0);
+    m_offset_sq = m_offset * m_offset;
+
+    double min_x = *std::min_element(xs.begin(), xs.end()) - m_offset;
+    double max_x = *std::max_element(xs.begin(), xs.end()) + m_offset;
+    double min_y = *std::min_element(ys.begin(), ys.end()) - m_offset;
+    double max_y = *std::max_element(ys.begin(), ys.end()) + m_offset;
+    double span = std::max(max_x - min_x, max_y - min_y);
+    if (span <= 0) span = 1;
+
+    m_min_x = min_x;
+    m_min_y = min_y;
+    m_cell_size = span / cells;
+    m_cols = std::max(1u, (unsigned int)std::ceil((max_x - min_x) / m_cell_size));
+    m_rows = std::max(1u, (unsigned int)std::ceil((max_y - min_y) / m_cell_size));
+
+    // Any point in a cell is within this distance of the cell center. Pad
+    // it slightly so rounding never drops an edge that sits right at the
+    // limit, extra edges only cost a little time.
+    double cell_radius = m_cell_size * std::sqrt(0.5);
+    double near_dist = (m_offset + cell_radius) * (1 + 1e-6);
+    double near_dist_sq = near_dist * near_dist;
+
+    unsigned int num_cells = m_cols * m_rows;
+    unsigned int num_edges = m_xs.size();
+    m_center_in_poly.resize(num_cells);
+    m_center_in_region.resize(num_cells);
+    m_edge_start.resize(num_cells + 1);
+
+    for (unsigned int row = 0; row < m_rows; row++) {
+        double cy = cellCenterY(row);
+        for (unsigned int col = 0; col < m_cols; col++) {
+            double cx = cellCenterX(col);
+            unsigned int cell = row * m_cols + col;
+            m_edge_start[cell] = m_edges.size();
+
+            bool in_poly = insidePolygon(cx, cy);
+            bool near_edge = false;
+            for (unsigned int e = 0; e < num_edges; e++) {
+                double dist_sq = distSqToEdge(e, cx, cy);
+                if (dist_sq <= near_dist_sq) m_edges.push_back(e);
+                if (dist_sq <= m_offset_sq) near_edge = true;
+            }
+            m_center_in_poly[cell] = in_poly;
+            m_center_in_region[cell] = in_poly || near_edge;
+        }
+    }
+    m_edge_start[num_cells] = m_edges.size();
+    return true;
+}
+
+bool PolygonGrid::contains(double x, double y) const
+{
+    if (m_cols == 0) return false;
+
+    double fx = (x - m_min_x) / m_cell_size;
+    double fy = (y - m_min_y) / m_cell_size;
+    if (!(fx >= 0 && fy >= 0 && fx <= m_cols && fy <= m_rows)) return false;
+
+    // Points on the far edges of the box belong to the last row/column
+    unsigned int col = std::min((unsigned int)fx, m_cols - 1);
+    unsigned int row = std::min((unsigned int)fy, m_rows - 1);
+    unsigned int cell = row * m_cols + col;
+    uint32_t first = m_edge_start[cell];
+    uint32_t last = m_edge_start[cell + 1];
+
+    // No boundary nearby, the whole cell shares the center's answer
+    if (first == last) return m_center_in_region[cell];
+
+    // Any edge within offset of the point is in this cell's list, and so
+    // is any edge crossing the segment from the cell center to the point
+    double cx = cellCenterX(col);
+    double cy = cellCenterY(row);
+    bool in_poly = m_center_in_poly[cell];
+    for (uint32_t i = first; i < last; i++) {
+        unsigned int e = m_edges[i];
+        if (distSqToEdge(e, x, y) <= m_offset_sq) return true;
+        if (segmentCrossesEdge(e, cx, cy, x, y)) in_poly = !in_poly;
+    }
+    return in_poly;
+}
+
+bool PolygonGrid::containsExact(double x, double y) const
+{
+    if (m_xs.empty()) return false;
+    if (insidePolygon(x, y)) return true;
+    for (unsigned int e = 0; e < m_xs.size(); e++) {
+        if (distSqToEdge(e, x, y) <= m_offset_sq) return true;
+    }
+    return false;
+}
+
+// Even-odd test against a ray cast from a point left of the polygon, using
+// the same crossing rule as contains() so the two stay consistent
+bool PolygonGrid::insidePolygon(double x, double y) const
+{
+    double far_x = *std::min_element(m_xs.begin(), m_xs.end()) - 1.0;
+    bool inside = false;
+    for (unsigned int e = 0; e < m_xs.size(); e++) {
+        if (segmentCrossesEdge(e, far_x, y, x, y)) inside = !inside;
+    }
+    return inside;
+}
+
+double PolygonGrid::distSqToEdge(unsigned int edge, double x, double y) const
+{
+    unsigned int next = (edge + 1) % m_xs.size();
+    double x1 = m_xs[edge], y1 = m_ys[edge];
+    double dx = m_xs[next] - x1, dy = m_ys[next] - y1;
+    double len_sq = dx * dx + dy * dy;
+    double t = 0;
+    if (len_sq > 0) {
+        t = ((x - x1) * dx + (y - y1) * dy) / len_sq;
+        t = std::min(1.0, std::max(0.0, t));
+    }
+    double px = x1 + t * dx - x, py = y1 + t * dy - y;
+    return px * px + py * py;
+}
+
+// Proper crossing of segment a-b with the edge. Points exactly on a line
+// are treated as lying on its negative side, so a segment through a
+// vertex counts exactly one of the two edges meeting there.
+bool PolygonGrid::segmentCrossesEdge(unsigned int edge, double ax, double ay,
+                                     double bx, double by) const
+{
+    unsigned int next = (edge + 1) % m_xs.size();
+    double cx = m_xs[edge], cy = m_ys[edge];
+    double dx = m_xs[next], dy = m_ys[next];
+
+    bool c_side = ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax)) > 0;
+    bool d_side = ((bx - ax) * (dy - ay) - (by - ay) * (dx - ax)) > 0;
+    if (c_side == d_side) return false;
+
+    bool a_side = ((dx - cx) * (ay - cy) - (dy - cy) * (ax - cx)) > 0;
+    bool b_side = ((dx - cx) * (by - cy) - (dy - cy) * (bx - cx)) > 0;
+    return a_side != b_side;
+}
+
+double PolygonGrid::cellCenterX(unsigned int col) const
+{
+    return m_min_x + (col + 0.5) * m_cell_size;
+}
+
+double PolygonGrid::cellCenterY(unsigned int row) const
+{
+    return m_min_y + (row + 0.5) * m_cell_size;
+}
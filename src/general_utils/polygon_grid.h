@@ -0,0 +1,67 @@
+#ifndef POLYGON_GRID_H
+#define POLYGON_GRID_H
+
+#include "XYPolygon.h"
+#include <vector>
+#include <cstdint>
+
+// Precomputed lookup for "is this point inside the polygon, or within
+// offset of its boundary". The polygon's bounding box (grown by offset)
+// is split into a coarse grid. Each cell stores the answer for its center
+// and the few edges that could change that answer somewhere in the cell,
+// so most queries are a single array lookup and the rest only test a
+// handful of edges. Works for non-convex polygons.
+class PolygonGrid {
+  public:
+    PolygonGrid();
+
+    // Build from a polygon and a buffer distance (>= 0). cells is the
+    // number of grid cells along the longer side of the bounding box.
+    // Returns false (and leaves the grid empty) for fewer than 3 vertices.
+    bool build(const XYPolygon& poly, double offset, unsigned int cells = 64);
+    bool build(const std::vector<double>& xs, const std::vector<double>& ys,
+               double offset, unsigned int cells = 64);
+
+    void clear();
+
+    // True if (x,y) is inside the polygon or within offset of an edge.
+    // Always false for an empty grid.
+    bool contains(double x, double y) const;
+
+    // Same answer as contains(), checked against every edge. Used for
+    // testing and as a reference; O(vertices).
+    bool containsExact(double x, double y) const;
+
+    bool empty() const { return m_xs.empty(); }
+    unsigned int cols() const { return m_cols; }
+    unsigned int rows() const { return m_rows; }
+    double offset() const { return m_offset; }
+
+  private:
+    bool insidePolygon(double x, double y) const;
+    double distSqToEdge(unsigned int edge, double x, double y) const;
+    bool segmentCrossesEdge(unsigned int edge, double ax, double ay,
+                            double bx, double by) const;
+    double cellCenterX(unsigned int col) const;
+    double cellCenterY(unsigned int row) const;
+
+  private:
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+    double m_offset;
+    double m_offset_sq;
+
+    double m_min_x;
+    double m_min_y;
+    double m_cell_size;
+    unsigned int m_cols;
+    unsigned int m_rows;
+
+    // Per cell, row-major
+    std::vector<uint8_t> m_center_in_poly;    // center inside the polygon
+    std::vector<uint8_t> m_center_in_region;  // center inside or within offset
+    std::vector<uint32_t> m_edge_start;       // cells+1 offsets into m_edges
+    std::vector<uint32_t> m_edges;            // edges near each cell
+};
+
+#endif // POLYGON_GRID_H
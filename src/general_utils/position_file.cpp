@@ -0,0 +1,77 @@
+#include "position_file.h"
+#include <algorithm>
+#include <cstring>
+
+static const char POSITION_MAGIC[4] = {'P', 'O', 'S', 'B'};
+static const uint32_t POSITION_VERSION = 1;
+static const size_t POSITION_HEADER_SIZE = 24;
+static const size_t POSITION_COUNT_OFFSET = 16;
+static const size_t POSITION_WRITE_RECORDS = 4096;
+
+bool PositionFileWriter::open(const std::string& path) {
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) return false;
+
+    // The count is filled in by close()
+    uint32_t fields[3] = {POSITION_VERSION, (uint32_t)sizeof(PositionRecord), 0};
+    uint64_t count = 0;
+    m_file.write(POSITION_MAGIC, sizeof(POSITION_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    m_file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    m_count = 0;
+    m_ok = m_file.good();
+    return m_ok;
+}
+
+void PositionFileWriter::append(const PositionRecord& record) {
+    m_buffer.push_back(record);
+    m_count++;
+    if (m_buffer.size() >= POSITION_WRITE_RECORDS) writeBuffer();
+}
+
+bool PositionFileWriter::writeBuffer() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(PositionRecord));
+    m_buffer.clear();
+    m_ok = m_ok && m_file.good();
+    return m_ok;
+}
+
+bool PositionFileWriter::close() {
+    if (!m_file.is_open()) return m_ok;
+    writeBuffer();
+    m_file.seekp(POSITION_COUNT_OFFSET);
+    m_file.write(reinterpret_cast<const char*>(&m_count), sizeof(m_count));
+    m_file.close();
+    m_ok = m_ok && !m_file.fail();
+    return m_ok;
+}
+
+bool PositionFile::open(const std::string& path) {
+    m_records = nullptr;
+    m_size = 0;
+    if (!m_file.open(path) || m_file.size() < POSITION_HEADER_SIZE) return false;
+
+    const char* data = m_file.data();
+    uint32_t version, record_size;
+    uint64_t count;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&record_size, data + 8, sizeof(record_size));
+    std::memcpy(&count, data + POSITION_COUNT_OFFSET, sizeof(count));
+    if (std::memcmp(data, POSITION_MAGIC, sizeof(POSITION_MAGIC)) != 0) return false;
+    if (version != POSITION_VERSION || record_size != sizeof(PositionRecord)) return false;
+    if (count > (m_file.size() - POSITION_HEADER_SIZE) / sizeof(PositionRecord)) return false;
+
+    // The mapping is page aligned and the header is a multiple of 8 bytes,
+    // so the records can be used in place
+    m_records = reinterpret_cast<const PositionRecord*>(data + POSITION_HEADER_SIZE);
+    m_size = count;
+    return true;
+}
+
+size_t PositionFile::lowerBound(double time) const {
+    const PositionRecord* end = m_records + m_size;
+    const PositionRecord* it = std::lower_bound(m_records, end, time,
+        [](const PositionRecord& record, double t) { return record.time < t; });
+    return it - m_records;
+}
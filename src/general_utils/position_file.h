@@ -0,0 +1,61 @@
+#ifndef POSITION_FILE_H
+#define POSITION_FILE_H
+
+#include "mapped_file.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// One row of a vehicle's position history. Missing heading or speed are
+// stored as NaN.
+struct PositionRecord {
+  double time;
+  double x;
+  double y;
+  double hdg;
+  double spd;
+};
+static_assert(sizeof(PositionRecord) == 5 * sizeof(double), "PositionRecord must be packed");
+
+// Binary twin of a *_positions.csv file: a 24 byte header ("POSB" magic,
+// uint32 version, uint32 record size, uint32 reserved, uint64 record
+// count) followed by the records, in native byte order. Records are in
+// the order they were logged, so time is non-decreasing.
+class PositionFileWriter {
+  public:
+    ~PositionFileWriter() { close(); }
+
+    bool open(const std::string& path);
+    void append(const PositionRecord& record);
+    // Write out buffered records and the final count. Returns false if
+    // anything failed to write.
+    bool close();
+
+  private:
+    bool writeBuffer();
+
+    std::ofstream m_file;
+    std::vector<PositionRecord> m_buffer;
+    uint64_t m_count = 0;
+    bool m_ok = false;
+};
+
+// Memory-mapped reader for files written by PositionFileWriter
+class PositionFile {
+  public:
+    bool open(const std::string& path);
+
+    size_t size() const { return m_size; }
+    const PositionRecord& operator[](size_t i) const { return m_records[i]; }
+
+    // Index of the first record at or after time, or size() if none
+    size_t lowerBound(double time) const;
+
+  private:
+    MappedFile m_file;
+    const PositionRecord* m_records = nullptr;
+    size_t m_size = 0;
+};
+
+#endif // POSITION_FILE_H
@@ -0,0 +1,54 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <vector>
+#include <cstddef>
+
+// Fixed-capacity buffer that keeps the most recent entries. Slots are
+// reused in place once the buffer wraps, so pushing never allocates
+// after setCapacity() as long as T itself reuses its storage on assignment.
+template <typename T>
+class RingBuffer {
+  public:
+    RingBuffer(size_t capacity = 0) { setCapacity(capacity); }
+
+    // Resize the buffer. This drops any entries currently held.
+    void setCapacity(size_t capacity) {
+        m_slots.assign(capacity, T());
+        m_next = 0;
+        m_size = 0;
+        m_total = 0;
+    }
+
+    // Get the slot for a new entry, overwriting the oldest if full.
+    // Only valid when capacity() > 0.
+    T& push() {
+        T& slot = m_slots[m_next];
+        m_next = (m_next + 1) % m_slots.size();
+        if (m_size < m_slots.size()) m_size++;
+        m_total++;
+        return slot;
+    }
+
+    // Entries in order from oldest (0) to newest (size()-1)
+    const T& operator[](size_t i) const {
+        return m_slots[(m_next + m_slots.size() - m_size + i) % m_slots.size()];
+    }
+
+    void clear() { m_next = 0; m_size = 0; }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_slots.size(); }
+    bool empty() const { return m_size == 0; }
+
+    // Number of entries ever pushed, including ones since overwritten
+    unsigned long total() const { return m_total; }
+
+  private:
+    std::vector<T> m_slots;
+    size_t m_next;
+    size_t m_size;
+    unsigned long m_total;
+};
+
+#endif // RING_BUFFER_H
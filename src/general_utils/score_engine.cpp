@@ -0,0 +1,94 @@
+#include "score_engine.h"
+#include "MBUtils.h"
+#include <cmath>
+#include <fstream>
+
+ScoreEngine::ScoreEngine() {
+    m_cell_size = 5;
+    m_swimmers = 0;
+    m_team_rescues = 0;
+}
+
+void ScoreEngine::setRegion(const XYPolygon& poly) {
+    m_team_coverage.setRegion(poly, m_cell_size);
+    for (auto& entry : m_vehicles) entry.second.coverage = m_team_coverage;
+}
+
+void ScoreEngine::addPosition(const std::string& vname, double x, double y) {
+    VehicleScore& score = m_vehicles[vname];
+    if (score.has_position) score.path_length += std::hypot(x - score.last_x, y - score.last_y);
+    score.has_position = true;
+    score.last_x = x;
+    score.last_y = y;
+
+    // A vehicle's first report starts from a copy of the empty team grid
+    if (score.coverage.empty() && !m_team_coverage.empty()) {
+        score.coverage = m_team_coverage;
+        score.coverage.reset();
+    }
+    score.coverage.add(x, y);
+    m_team_coverage.add(x, y);
+}
+
+void ScoreEngine::addRescue(const std::string& vname, double rescue_time, double alert_time) {
+    VehicleScore& score = m_vehicles[vname];
+    score.rescues++;
+    if (alert_time >= 0 && rescue_time >= alert_time) {
+        score.ttr_total += rescue_time - alert_time;
+        score.ttr_count++;
+    }
+    m_team_rescues++;
+}
+
+double ScoreEngine::teamPathLength() const {
+    double total = 0;
+    for (const auto& entry : m_vehicles) total += entry.second.path_length;
+    return total;
+}
+
+double ScoreEngine::meanTimeToRescue() const {
+    double total = 0;
+    unsigned int count = 0;
+    for (const auto& entry : m_vehicles) {
+        total += entry.second.ttr_total;
+        count += entry.second.ttr_count;
+    }
+    return (count > 0) ? total / count : 0;
+}
+
+double ScoreEngine::meanTimeToRescue(const VehicleScore& score) {
+    return (score.ttr_count > 0) ? score.ttr_total / score.ttr_count : 0;
+}
+
+std::string ScoreEngine::buildSpec() const {
+    std::string spec = "rescues=" + uintToString(m_team_rescues);
+    spec += ",swimmers=" + uintToString(m_swimmers);
+    spec += ",mean_ttr=" + doubleToStringX(meanTimeToRescue(), 2);
+    spec += ",coverage=" + doubleToStringX(teamCoverage(), 4);
+    spec += ",path_len=" + doubleToStringX(teamPathLength(), 1);
+    return spec;
+}
+
+std::string ScoreEngine::getSpec() {
+    m_last_spec = buildSpec();
+    return m_last_spec;
+}
+
+bool ScoreEngine::writeSummary(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    out << "vname,rescues,mean_time_to_rescue,path_length,coverage" << std::endl;
+    for (const auto& entry : m_vehicles) {
+        const VehicleScore& score = entry.second;
+        out << entry.first << "," << score.rescues << ","
+            << doubleToString(meanTimeToRescue(score), 2) << ","
+            << doubleToString(score.path_length, 2) << ","
+            << doubleToString(score.coverage.coverage(), 4) << std::endl;
+    }
+    out << "team," << m_team_rescues << ","
+        << doubleToString(meanTimeToRescue(), 2) << ","
+        << doubleToString(teamPathLength(), 2) << ","
+        << doubleToString(teamCoverage(), 4) << std::endl;
+    return out.good();
+}
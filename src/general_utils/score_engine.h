@@ -0,0 +1,76 @@
+#ifndef SCORE_ENGINE_H
+#define SCORE_ENGINE_H
+
+#include "coverage_grid.h"
+#include "XYPolygon.h"
+#include <map>
+#include <string>
+
+// Running per-vehicle and team metrics, updated as reports arrive so a
+// trial's score is known the moment the mission ends. Coverage is kept
+// in a CoverageGrid per vehicle plus one for the team.
+class ScoreEngine {
+  public:
+    struct VehicleScore {
+        unsigned int rescues = 0;
+        double ttr_total = 0;  // Sum of known times-to-rescue
+        unsigned int ttr_count = 0;
+        double path_length = 0;
+        CoverageGrid coverage;
+
+        bool has_position = false;
+        double last_x = 0;
+        double last_y = 0;
+    };
+
+    ScoreEngine();
+
+    // Coverage cells are squares of this size (meters). Takes effect on
+    // the next setRegion().
+    void setCellSize(double cell_size) { m_cell_size = cell_size; }
+
+    // Coverage is measured over this region. Resets coverage so far.
+    void setRegion(const XYPolygon& poly);
+
+    void addSwimmer() { m_swimmers++; }
+    void addPosition(const std::string& vname, double x, double y);
+    // alert_time < 0 if the swimmer's alert was never seen
+    void addRescue(const std::string& vname, double rescue_time, double alert_time);
+
+    unsigned int swimmers() const { return m_swimmers; }
+    unsigned int teamRescues() const { return m_team_rescues; }
+    double teamPathLength() const;
+    double teamCoverage() const { return m_team_coverage.coverage(); }
+    const CoverageGrid& teamCoverageGrid() const { return m_team_coverage; }
+    double meanTimeToRescue() const;
+
+    static double meanTimeToRescue(const VehicleScore& score);
+
+    const std::map<std::string, VehicleScore>& vehicles() const { return m_vehicles; }
+
+    // True if getSpec() would now differ from what it last returned, at
+    // the precision it reports. Moving within a covered cell or repeating
+    // a position doesn't count.
+    bool changed() const { return buildSpec() != m_last_spec; }
+    // e.g. rescues=3,swimmers=12,mean_ttr=41.2,coverage=0.312,path_len=1804.6
+    std::string getSpec();
+
+    // One row per vehicle plus a "team" row
+    bool writeSummary(const std::string& path) const;
+
+  private:
+    std::string buildSpec() const;
+
+    double m_cell_size;
+
+    // Kept in step with the vehicles' grids rather than merged from them,
+    // so the running score never has to touch every cell
+    CoverageGrid m_team_coverage;
+
+    unsigned int m_swimmers;
+    unsigned int m_team_rescues;
+    std::map<std::string, VehicleScore> m_vehicles;
+    std::string m_last_spec;
+};
+
+#endif // SCORE_ENGINE_H
@@ -0,0 +1,397 @@
+#include "swim_file.h"
+#include "general_utils.h"
+#include "mapped_file.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+// Random points tried per swimmer before falling back to a full fill
+static const unsigned int DART_ATTEMPTS_PER_SWIMMER = 30;
+
+// Candidates tried around each active point in Bridson's algorithm
+static const unsigned int BRIDSON_CANDIDATES = 30;
+
+// Random points tried for a new Bridson seed, e.g. in a part of a
+// non-convex region the fill hasn't reached
+static const unsigned int SEED_ATTEMPTS = 100;
+
+bool parsePolyPoints(std::string_view spec, std::vector<double>& xs, std::vector<double>& ys) {
+    xs.clear();
+    ys.clear();
+
+    size_t open = spec.find('{');
+    if (open != std::string_view::npos) {
+        size_t close = spec.find('}', open);
+        if (close == std::string_view::npos) return false;
+        spec = spec.substr(open + 1, close - open - 1);
+    }
+
+    while (!spec.empty()) {
+        size_t colon = spec.find(':');
+        std::string_view vertex = spec.substr(0, colon);
+        size_t comma = vertex.find(',');
+        if (comma == std::string_view::npos) return false;
+
+        // Extra fields (e.g. a z value) after x,y are ignored
+        std::string_view y_field = vertex.substr(comma + 1);
+        y_field = y_field.substr(0, y_field.find(','));
+        double x, y;
+        if (!parseDoubleView(vertex.substr(0, comma), x) || !parseDoubleView(y_field, y))
+            return false;
+        xs.push_back(x);
+        ys.push_back(y);
+
+        if (colon == std::string_view::npos) break;
+        spec.remove_prefix(colon + 1);
+    }
+    return !xs.empty();
+}
+
+static std::string_view trim(std::string_view str) {
+    size_t start = str.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) return std::string_view();
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(start, end - start + 1);
+}
+
+// "type=reg, name=p01, x=1, y=2" into swimmer, in place
+static bool parseSwimmerSpec(std::string_view spec, SwimmerSpec& swimmer) {
+    bool has_x = false;
+    bool has_y = false;
+    while (!spec.empty()) {
+        size_t comma = spec.find(',');
+        std::string_view part = spec.substr(0, comma);
+        spec.remove_prefix(comma == std::string_view::npos ? spec.size() : comma + 1);
+
+        size_t eq = part.find('=');
+        if (eq == std::string_view::npos) continue;
+        std::string_view key = trim(part.substr(0, eq));
+        std::string_view val = trim(part.substr(eq + 1));
+        if (key == "x")
+            has_x = parseDoubleView(val, swimmer.x);
+        else if (key == "y")
+            has_y = parseDoubleView(val, swimmer.y);
+        else if (key == "name")
+            swimmer.name.assign(val.data(), val.size());
+        else if (key == "type")
+            swimmer.type.assign(val.data(), val.size());
+    }
+    return has_x && has_y;
+}
+
+bool parseSwimFile(std::string_view text, SwimScenario& scenario, unsigned int* bad_line) {
+    scenario = SwimScenario();
+    if (bad_line) *bad_line = 0;
+
+    unsigned int line_num = 0;
+    while (!text.empty()) {
+        size_t newline = text.find('\n');
+        std::string_view line = trim(text.substr(0, newline));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        line_num++;
+
+        if (line.empty() || line.substr(0, 2) == "//") continue;
+        size_t eq = line.find('=');
+        if (eq == std::string_view::npos) continue;
+        std::string_view key = trim(line.substr(0, eq));
+        std::string_view value = trim(line.substr(eq + 1));
+
+        bool ok = true;
+        if (key == "swimmer") {
+            scenario.swimmers.emplace_back();
+            ok = parseSwimmerSpec(value, scenario.swimmers.back());
+        } else if (key == "poly") {
+            ok = parsePolyPoints(value, scenario.poly_xs, scenario.poly_ys);
+        }
+        if (!ok) {
+            if (bad_line) *bad_line = line_num;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadSwimFile(const std::string& path, SwimScenario& scenario, unsigned int* bad_line) {
+    if (bad_line) *bad_line = 0;
+    MappedFile file;
+    if (!file.open(path)) {
+        scenario = SwimScenario();
+        return false;
+    }
+    return parseSwimFile(file.view(), scenario, bad_line);
+}
+
+double minSwimmerSeparation(const SwimScenario& scenario) {
+    const std::vector<SwimmerSpec>& swimmers = scenario.swimmers;
+    double min_dist_sq = -1;
+    for (size_t i = 0; i < swimmers.size(); i++) {
+        for (size_t j = i + 1; j < swimmers.size(); j++) {
+            double dx = swimmers[i].x - swimmers[j].x;
+            double dy = swimmers[i].y - swimmers[j].y;
+            double dist_sq = dx * dx + dy * dy;
+            if (min_dist_sq < 0 || dist_sq < min_dist_sq) min_dist_sq = dist_sq;
+        }
+    }
+    return (min_dist_sq < 0) ? 0 : std::sqrt(min_dist_sq);
+}
+
+// Up to digits decimals, trailing zeros (and a bare point) dropped
+static void appendNumber(std::string& out, double val, int digits) {
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "%.*f", digits, val);
+    if (len <= 0) return;
+    if (strchr(buf, '.')) {
+        while (len > 0 && buf[len - 1] == '0') len--;
+        if (len > 0 && buf[len - 1] == '.') len--;
+    }
+    if (len == 2 && buf[0] == '-' && buf[1] == '0') {
+        buf[0] = '0';
+        len = 1;
+    }
+    out.append(buf, len);
+}
+
+std::string formatSwimFile(const SwimScenario& scenario, const std::string& header, int precision) {
+    std::string out;
+    out.reserve(64 * (scenario.swimmers.size() + 4));
+
+    size_t start = 0;
+    while (start < header.size()) {
+        size_t end = header.find('\n', start);
+        if (end == std::string::npos) end = header.size();
+        out += "// ";
+        out.append(header, start, end - start);
+        out += "\n";
+        start = end + 1;
+    }
+
+    if (!scenario.poly_xs.empty()) {
+        out += "poly = pts={";
+        for (size_t i = 0; i < scenario.poly_xs.size(); i++) {
+            if (i > 0) out += ":";
+            appendNumber(out, scenario.poly_xs[i], 6);
+            out += ",";
+            appendNumber(out, scenario.poly_ys[i], 6);
+        }
+        out += "}\n";
+    }
+
+    for (const SwimmerSpec& swimmer : scenario.swimmers) {
+        out += "swimmer = ";
+        if (!swimmer.type.empty()) {
+            out += "type=";
+            out += swimmer.type;
+            out += ", ";
+        }
+        out += "name=";
+        out += swimmer.name;
+        out += ", x=";
+        appendNumber(out, swimmer.x, precision);
+        out += ", y=";
+        appendNumber(out, swimmer.y, precision);
+        out += "\n";
+    }
+    return out;
+}
+
+bool writeSwimFile(const std::string& path, const SwimScenario& scenario,
+                   const std::string& header, int precision) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    std::string text = formatSwimFile(scenario, header, precision);
+    out.write(text.data(), text.size());
+    return out.good();
+}
+
+SwimFieldGenerator::SwimFieldGenerator() {
+    m_min_x = m_min_y = m_max_x = m_max_y = 0;
+    m_sep = 0;
+    m_cell_size = 1;
+    m_cols = 0;
+    m_rows = 0;
+    setPrecision(1);
+}
+
+bool SwimFieldGenerator::setRegion(const std::vector<double>& xs, const std::vector<double>& ys) {
+    m_poly_xs.clear();
+    m_poly_ys.clear();
+    if (xs.size() < 3 || xs.size() != ys.size() || !m_region.build(xs, ys, 0)) {
+        m_region.clear();
+        return false;
+    }
+
+    m_poly_xs = xs;
+    m_poly_ys = ys;
+    m_min_x = *std::min_element(xs.begin(), xs.end());
+    m_max_x = *std::max_element(xs.begin(), xs.end());
+    m_min_y = *std::min_element(ys.begin(), ys.end());
+    m_max_y = *std::max_element(ys.begin(), ys.end());
+    return true;
+}
+
+void SwimFieldGenerator::setPrecision(int digits) {
+    m_precision = std::max(0, std::min(digits, 9));
+    m_scale = std::pow(10.0, m_precision);
+}
+
+// [low, high) from the top 53 bits, so a seed gives the same numbers with
+// any standard library (uniform_real_distribution is implementation
+// defined)
+double SwimFieldGenerator::uniform(double low, double high) {
+    double unit = (m_rng() >> 11) * (1.0 / 9007199254740992.0);
+    return low + unit * (high - low);
+}
+
+double SwimFieldGenerator::snap(double val) const {
+    return std::round(val * m_scale) / m_scale;
+}
+
+bool SwimFieldGenerator::randomInteriorPoint(double& x, double& y) {
+    for (unsigned int i = 0; i < 1000; i++) {
+        x = snap(uniform(m_min_x, m_max_x));
+        y = snap(uniform(m_min_y, m_max_y));
+        if (m_region.contains(x, y)) return true;
+    }
+    return false;
+}
+
+void SwimFieldGenerator::resetGrid() {
+    m_xs.clear();
+    m_ys.clear();
+    m_active.clear();
+    if (m_sep <= 0) {
+        m_cols = m_rows = 0;
+        return;
+    }
+
+    // Cells of sep/sqrt(2) hold at most one point
+    m_cell_size = m_sep / std::sqrt(2.0);
+    m_cols = (unsigned int)std::ceil((m_max_x - m_min_x) / m_cell_size) + 1;
+    m_rows = (unsigned int)std::ceil((m_max_y - m_min_y) / m_cell_size) + 1;
+    m_grid.assign((size_t)m_cols * m_rows, 0);
+}
+
+// True if (x,y) is at least sep from every placed point. Points that
+// close can only be within two cells.
+bool SwimFieldGenerator::fits(double x, double y) const {
+    if (m_sep <= 0) return true;
+
+    int col = (int)std::floor((x - m_min_x) / m_cell_size);
+    int row = (int)std::floor((y - m_min_y) / m_cell_size);
+    double sep_sq = m_sep * m_sep;
+    for (int r = std::max(0, row - 2); r <= std::min((int)m_rows - 1, row + 2); r++) {
+        for (int c = std::max(0, col - 2); c <= std::min((int)m_cols - 1, col + 2); c++) {
+            uint32_t entry = m_grid[(size_t)r * m_cols + c];
+            if (entry == 0) continue;
+            double dx = m_xs[entry - 1] - x;
+            double dy = m_ys[entry - 1] - y;
+            if (dx * dx + dy * dy < sep_sq) return false;
+        }
+    }
+    return true;
+}
+
+void SwimFieldGenerator::insert(double x, double y) {
+    m_xs.push_back(x);
+    m_ys.push_back(y);
+    if (m_sep <= 0) return;
+
+    unsigned int col = std::min(m_cols - 1, (unsigned int)std::max(0.0, std::floor((x - m_min_x) / m_cell_size)));
+    unsigned int row = std::min(m_rows - 1, (unsigned int)std::max(0.0, std::floor((y - m_min_y) / m_cell_size)));
+    m_grid[(size_t)row * m_cols + col] = (uint32_t)m_xs.size();
+}
+
+bool SwimFieldGenerator::placeByDarts(unsigned int count) {
+    unsigned int attempts = DART_ATTEMPTS_PER_SWIMMER * count + SEED_ATTEMPTS;
+    while (m_xs.size() < count && attempts > 0) {
+        attempts--;
+        double x = snap(uniform(m_min_x, m_max_x));
+        double y = snap(uniform(m_min_y, m_max_y));
+        if (m_region.contains(x, y) && fits(x, y)) insert(x, y);
+    }
+    return m_xs.size() >= count;
+}
+
+// Bridson's algorithm: grow from active points by trying candidates in
+// the annulus [sep, 2*sep] around them, retiring a point once none fit.
+// When nothing is active, look for a new seed in any uncovered area.
+void SwimFieldGenerator::placeByBridson() {
+    while (true) {
+        if (m_active.empty()) {
+            bool seeded = false;
+            for (unsigned int i = 0; i < SEED_ATTEMPTS && !seeded; i++) {
+                double x, y;
+                if (randomInteriorPoint(x, y) && fits(x, y)) {
+                    insert(x, y);
+                    m_active.push_back(m_xs.size() - 1);
+                    seeded = true;
+                }
+            }
+            if (!seeded) return;
+        }
+
+        size_t slot = (size_t)uniform(0, m_active.size());
+        uint32_t index = m_active[slot];
+        bool placed = false;
+        for (unsigned int k = 0; k < BRIDSON_CANDIDATES && !placed; k++) {
+            double radius = uniform(m_sep, 2 * m_sep);
+            double angle = uniform(0, 2 * M_PI);
+            double x = snap(m_xs[index] + radius * std::cos(angle));
+            double y = snap(m_ys[index] + radius * std::sin(angle));
+            if (x < m_min_x || x > m_max_x || y < m_min_y || y > m_max_y) continue;
+            if (m_region.contains(x, y) && fits(x, y)) {
+                insert(x, y);
+                m_active.push_back(m_xs.size() - 1);
+                placed = true;
+            }
+        }
+        if (!placed) {
+            m_active[slot] = m_active.back();
+            m_active.pop_back();
+        }
+    }
+}
+
+bool SwimFieldGenerator::generate(unsigned int reg, unsigned int unreg, uint64_t seed,
+                                  SwimScenario& scenario) {
+    scenario = SwimScenario();
+    if (m_poly_xs.empty()) return false;
+
+    m_rng.seed(seed);
+    unsigned int total = reg + unreg;
+    resetGrid();
+
+    std::vector<uint32_t> order;
+    if (!placeByDarts(total)) {
+        if (m_sep <= 0) return false;
+        resetGrid();
+        placeByBridson();
+        if (m_xs.size() < total) return false;
+
+        // A uniform random subset of the full fill
+        order.resize(m_xs.size());
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+        for (uint32_t i = 0; i < total; i++) {
+            uint32_t j = i + (uint32_t)uniform(0, order.size() - i);
+            std::swap(order[i], order[j]);
+        }
+    }
+
+    scenario.poly_xs = m_poly_xs;
+    scenario.poly_ys = m_poly_ys;
+    scenario.swimmers.resize(total);
+    for (unsigned int i = 0; i < total; i++) {
+        uint32_t index = order.empty() ? i : order[i];
+        SwimmerSpec& swimmer = scenario.swimmers[i];
+        bool is_reg = (i < reg);
+        char name[16];
+        snprintf(name, sizeof(name), "%c%02u", is_reg ? 'p' : 'x', is_reg ? i + 1 : i - reg + 1);
+        swimmer.name = name;
+        if (unreg > 0) swimmer.type = is_reg ? "reg" : "unreg";
+        swimmer.x = m_xs[index];
+        swimmer.y = m_ys[index];
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef SWIM_FILE_H
+#define SWIM_FILE_H
+
+#include "polygon_grid.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+// One swimmer of a swim file
+struct SwimmerSpec {
+    std::string name;
+    std::string type;  // "reg", "unreg", or empty when the file has no types
+    double x = 0;
+    double y = 0;
+};
+
+// What a swim file holds: the region the swimmers were placed in and the
+// swimmers, in the format uFldRescueMgr reads (swim_file = ...)
+struct SwimScenario {
+    std::vector<double> poly_xs;
+    std::vector<double> poly_ys;
+    std::vector<SwimmerSpec> swimmers;
+};
+
+// Parse "x1,y1:x2,y2:..." into vertex lists. A surrounding pts={...} is
+// accepted. Returns false on a malformed vertex.
+bool parsePolyPoints(std::string_view spec, std::vector<double>& xs, std::vector<double>& ys);
+
+// Parse swim file text, as written by formatSwimFile or by hand, in one
+// pass over the text. Blank lines, // comments and other parameters are
+// skipped, and fields of a swimmer line other than type, name, x and y
+// are ignored. Returns false on a poly line that doesn't parse or a
+// swimmer without x and y, setting bad_line (1-based) if given.
+bool parseSwimFile(std::string_view text, SwimScenario& scenario, unsigned int* bad_line = nullptr);
+
+// parseSwimFile on a memory-mapped file. bad_line is 0 if the file
+// couldn't be opened.
+bool loadSwimFile(const std::string& path, SwimScenario& scenario, unsigned int* bad_line = nullptr);
+
+// Smallest distance between any two swimmers, 0 with fewer than two
+double minSwimmerSeparation(const SwimScenario& scenario);
+
+// Swim file text for a scenario. Each line of header is written as a
+// // comment first. Coordinates get up to precision decimals, with
+// trailing zeros dropped.
+std::string formatSwimFile(const SwimScenario& scenario, const std::string& header = "",
+                           int precision = 1);
+bool writeSwimFile(const std::string& path, const SwimScenario& scenario,
+                   const std::string& header = "", int precision = 1);
+
+// Seeded, reproducible swimmer placement inside a polygon with a minimum
+// separation between swimmers. Coordinates are rounded to the output
+// precision before they are checked, so the written file keeps the
+// separation exactly.
+//
+// Placement is Poisson-disk sampling over a background grid with cells of
+// sep/sqrt(2), so each check looks at a few cells rather than every
+// swimmer. Random points are tried first, which is fast when the region
+// has room to spare. If that fails, the region is filled completely with
+// Bridson's algorithm and a random subset is kept. The generator keeps
+// its buffers, so one instance can make many scenarios cheaply.
+class SwimFieldGenerator {
+  public:
+    SwimFieldGenerator();
+
+    // Returns false (and clears the region) for fewer than 3 vertices
+    bool setRegion(const std::vector<double>& xs, const std::vector<double>& ys);
+    void setSeparation(double sep) { m_sep = (sep > 0) ? sep : 0; }
+    void setPrecision(int digits);
+
+    // Place reg swimmers named p01.. then unreg ones named x01... Types
+    // are only set when unreg > 0, matching the files gen_swimmers wrote.
+    // The same seed always gives the same scenario. Returns false if
+    // the swimmers don't fit at this separation.
+    bool generate(unsigned int reg, unsigned int unreg, uint64_t seed, SwimScenario& scenario);
+
+  private:
+    double uniform(double low, double high);
+    bool randomInteriorPoint(double& x, double& y);
+    double snap(double val) const;
+    bool fits(double x, double y) const;
+    void insert(double x, double y);
+    void resetGrid();
+    bool placeByDarts(unsigned int count);
+    void placeByBridson();
+
+  private:
+    PolygonGrid m_region;
+    std::vector<double> m_poly_xs;
+    std::vector<double> m_poly_ys;
+    double m_min_x, m_min_y, m_max_x, m_max_y;
+
+    double m_sep;
+    int m_precision;
+    double m_scale;  // 10^precision
+
+    std::mt19937_64 m_rng;
+
+    // Background grid, row-major, holding point index + 1 (0 for empty)
+    double m_cell_size;
+    unsigned int m_cols;
+    unsigned int m_rows;
+    std::vector<uint32_t> m_grid;
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+    std::vector<uint32_t> m_active;
+};
+
+#endif // SWIM_FILE_H
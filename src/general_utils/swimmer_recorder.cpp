@@ -0,0 +1,42 @@
+#include "swimmer_recorder.h"
+
+SwimmerRecorder::SwimmerRecorder(TrajectoryStore& store, ScoreEngine& score)
+    : m_store(store), m_score(score) {}
+
+bool SwimmerRecorder::addAlert(uint32_t id, const std::string& id_str, double time, double x,
+                               double y) {
+    // A swimmer rescued before its alert is already known, but has no
+    // position yet and was already counted
+    bool is_new = !m_swimmers.has(id);
+    if (!m_swimmers.add(id, x, y)) return false;
+
+    m_store.append(entity(id, id_str), time, x, y, 0);
+    if (is_new) m_score.addSwimmer();
+    return true;
+}
+
+bool SwimmerRecorder::addRescue(uint32_t id, const std::string& id_str, double time,
+                                const std::string& finder) {
+    bool is_new = !m_swimmers.has(id);
+    if (!m_swimmers.setRescued(id)) return false;
+    uint32_t swimmer = entity(id, id_str);
+    if (is_new) m_score.addSwimmer();
+
+    uint32_t finder_id = TrajectoryStore::NO_ENTITY;
+    if (!finder.empty()) finder_id = m_store.entityId(finder, TrajectoryStore::VEHICLE);
+    m_store.addRescue(time, swimmer, finder_id);
+
+    // The swimmer's first sample is from its alert, if that came first
+    double alert_time = -1;
+    if (m_store.numSamples(swimmer) > 0) alert_time = m_store.time(swimmer, 0);
+    m_score.addRescue(finder.empty() ? "unknown" : finder, time, alert_time);
+    return true;
+}
+
+uint32_t SwimmerRecorder::entity(uint32_t id, const std::string& id_str) {
+    if (id >= m_entities.size())
+        m_entities.resize(m_swimmers.endId(), uint32_t(TrajectoryStore::NO_ENTITY));
+    if (m_entities[id] == TrajectoryStore::NO_ENTITY)
+        m_entities[id] = m_store.entityId("swimmer_" + id_str, TrajectoryStore::SWIMMER);
+    return m_entities[id];
+}
@@ -0,0 +1,41 @@
+#ifndef SWIMMER_RECORDER_H
+#define SWIMMER_RECORDER_H
+
+#include "score_engine.h"
+#include "swimmer_store.h"
+#include "trajectory_store.h"
+#include <string>
+#include <vector>
+
+// Records swimmer alerts and rescues into a TrajectoryStore and a
+// ScoreEngine, as uFldRecordKeeper receives them. Either can come first
+// for an id: a swimmer counts once, and its alert still gives it a
+// position and a sample when the rescue was reported before it.
+class SwimmerRecorder {
+  public:
+    // Both must outlive the recorder
+    SwimmerRecorder(TrajectoryStore& store, ScoreEngine& score);
+
+    // Returns false for a repeated alert or an id that is too large.
+    // id_str is the id as given, used to name the swimmer's entity.
+    bool addAlert(uint32_t id, const std::string& id_str, double time, double x, double y);
+
+    // Returns false for a repeated rescue or an id that is too large.
+    // finder may be empty if unknown.
+    bool addRescue(uint32_t id, const std::string& id_str, double time, const std::string& finder);
+
+    const SwimmerStore& swimmers() const { return m_swimmers; }
+
+  private:
+    // The store entity for a swimmer, added the first time the id is seen
+    uint32_t entity(uint32_t id, const std::string& id_str);
+
+    TrajectoryStore& m_store;
+    ScoreEngine& m_score;
+
+    // Swimmers by id, and each one's store entity, indexed the same way
+    SwimmerStore m_swimmers;
+    std::vector<uint32_t> m_entities;
+};
+
+#endif // SWIMMER_RECORDER_H
@@ -0,0 +1,54 @@
+#include "swimmer_store.h"
+
+SwimmerStore::SwimmerStore() {
+    m_count = 0;
+    m_num_rescued = 0;
+}
+
+void SwimmerStore::reserve(uint32_t end_id) {
+    if (end_id > MAX_ID) end_id = MAX_ID;
+    if (end_id <= m_status.size()) return;
+
+    // Grow geometrically so ids arriving one at a time stay amortized O(1)
+    size_t size = m_status.size() * 2;
+    if (size < end_id) size = end_id;
+    if (size > MAX_ID) size = MAX_ID;
+    m_xs.resize(size, 0);
+    m_ys.resize(size, 0);
+    m_status.resize(size, 0);
+    m_rescued.resize((size + 63) / 64, 0);
+}
+
+void SwimmerStore::clear() {
+    m_xs.clear();
+    m_ys.clear();
+    m_status.clear();
+    m_rescued.clear();
+    m_count = 0;
+    m_num_rescued = 0;
+}
+
+bool SwimmerStore::ensure(uint32_t id) {
+    if (id >= MAX_ID) return false;
+    if (id >= m_status.size()) reserve(id + 1);
+    if (!(m_status[id] & KNOWN)) {
+        m_status[id] |= KNOWN;
+        m_count++;
+    }
+    return true;
+}
+
+bool SwimmerStore::add(uint32_t id, double x, double y) {
+    if (hasPosition(id) || !ensure(id)) return false;
+    m_xs[id] = x;
+    m_ys[id] = y;
+    m_status[id] |= POSITIONED;
+    return true;
+}
+
+bool SwimmerStore::setRescued(uint32_t id) {
+    if (rescued(id) || !ensure(id)) return false;
+    m_rescued[id >> 6] |= uint64_t(1) << (id & 63);
+    m_num_rescued++;
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef SWIMMER_STORE_H
+#define SWIMMER_STORE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Swimmers indexed directly by id. uFldRescueMgr numbers swimmers from 1,
+// so ids are small and dense and a lookup is an array index. Positions and
+// status live in parallel arrays with the rescued flags in a bitset,
+// about 17 bytes per id, and walking every swimmer is a linear scan.
+//
+// A swimmer can be known before its position is, e.g. when its rescue is
+// reported before its alert. The first position given is kept.
+class SwimmerStore {
+  public:
+    // Ids at or above this are refused rather than growing the arrays
+    static constexpr uint32_t MAX_ID = 1u << 20;
+
+    SwimmerStore();
+
+    // Grow the arrays to hold ids below end_id, e.g. once per batch
+    void reserve(uint32_t end_id);
+    void clear();
+
+    // Add a swimmer, or give a known swimmer without a position this
+    // one. Returns false if the id already had a position or is too large.
+    bool add(uint32_t id, double x, double y);
+
+    // Mark a swimmer rescued, adding it without a position if it is new.
+    // Returns false if it was already rescued or the id is too large.
+    bool setRescued(uint32_t id);
+
+    bool has(uint32_t id) const { return id < m_status.size() && (m_status[id] & KNOWN); }
+    bool hasPosition(uint32_t id) const { return id < m_status.size() && (m_status[id] & POSITIONED); }
+    bool rescued(uint32_t id) const {
+        return id < m_status.size() && ((m_rescued[id >> 6] >> (id & 63)) & 1);
+    }
+    // Only meaningful when hasPosition(id)
+    double x(uint32_t id) const { return m_xs[id]; }
+    double y(uint32_t id) const { return m_ys[id]; }
+
+    // Known swimmers, and how many of them are rescued
+    size_t size() const { return m_count; }
+    size_t numRescued() const { return m_num_rescued; }
+    // One past the largest id slot, for iterating over ids
+    uint32_t endId() const { return (uint32_t)m_status.size(); }
+
+    // Call f(id, x, y) for every positioned swimmer not yet rescued, in
+    // id order
+    template <typename F>
+    void forEachActive(F f) const {
+        for (uint32_t id = 0; id < m_status.size(); id++) {
+            if ((m_status[id] & POSITIONED) && !((m_rescued[id >> 6] >> (id & 63)) & 1))
+                f(id, m_xs[id], m_ys[id]);
+        }
+    }
+
+  private:
+    bool ensure(uint32_t id);
+
+    enum : uint8_t { KNOWN = 1, POSITIONED = 2 };
+
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+    std::vector<uint8_t> m_status;
+    std::vector<uint64_t> m_rescued;
+    size_t m_count;
+    size_t m_num_rescued;
+};
+
+#endif // SWIMMER_STORE_H
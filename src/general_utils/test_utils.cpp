@@ -1,4 +1,13 @@
 #include "general_utils.h"
+#include "position_file.h"
+#include "polygon_grid.h"
+#include "trajectory_store.h"
+#include "coverage_grid.h"
+#include "swim_file.h"
+#include "swimmer_store.h"
+#include "vehicle_table.h"
+#include "score_engine.h"
+#include "swimmer_recorder.h"
 #include <iostream>
 #include <vector>
 
@@ -169,38 +178,706 @@ bool test_csvFilesAreEqual(int test_verbose = 0) {
         return false;
     if (test_verbose > 0) std::cout << "Passed with " << expected_csv << std::endl;
 
+    // A missing final newline doesn't count as a difference
+    std::string no_newline_csv = base + "/temp_no_newline.csv";
+    std::ifstream in(expected_csv);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream(no_newline_csv) << contents.substr(0, contents.size() - 1);
+    bool equal = csvFilesAreEqual(expected_csv, no_newline_csv, test_verbose);
+    std::filesystem::remove(no_newline_csv);
+    if (!equal)
+        return false;
+
     if (test_verbose > 0) std::cout << "Finish --- test_csvFilesAreEqual()" << std::endl;
     return true;
 }
 
+bool test_csvFilesAreClose(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_csvFilesAreClose()" << std::endl;
+    std::string base = "../resources/test";
+    std::string expected_csv = base + "/expected.csv";
+
+    // -55.72 vs -55.722 is only close with a loose enough tolerance
+    std::string extradigit_csv = base + "/incorrect_extradigit.csv";
+    if (csvFilesAreClose(expected_csv, extradigit_csv, 1e-9, 0.0, test_verbose)) return false;
+    if (!csvFilesAreClose(expected_csv, extradigit_csv, 0.0, 0.01, test_verbose)) return false;
+    if (!csvFilesAreClose(expected_csv, extradigit_csv, 1e-4, 0.0, test_verbose)) return false;
+
+    // Extra rows never match
+    if (csvFilesAreClose(expected_csv, base + "/incorrect_extraline.csv", 0.0, 1.0, test_verbose)) return false;
+    if (!csvFilesAreClose(expected_csv, base + "/copy.csv", 1e-9, 0.0, test_verbose)) return false;
+
+    // Numbers are compared by value and text by content
+    std::string temp_csv = base + "/temp_close.csv";
+    std::ifstream in(expected_csv);
+    std::ofstream out(temp_csv);
+    std::string line;
+    bool first = true;
+    while (std::getline(in, line)) {
+        if (first) out << "abe_x, abe_y\r\n";
+        else out << std::stod(line.substr(0, line.find(','))) << ",  " << line.substr(line.find(',') + 1) << "e0";
+        if (!first) out << "\n";
+        first = false;
+    }
+    out.close();
+    bool close = csvFilesAreClose(expected_csv, temp_csv, 1e-12, 0.0, test_verbose);
+    bool equal = csvFilesAreEqual(expected_csv, temp_csv, test_verbose);
+    std::filesystem::remove(temp_csv);
+    if (!close || equal) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_csvFilesAreClose()" << std::endl;
+    return true;
+}
+
+bool test_scanNodeReport(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_scanNodeReport()" << std::endl;
+    std::string report = "NAME=abe,X=47.59,Y=-49.46,SPD=1.12,HDG=122.11,DEP=0,TYPE=KAYAK,MODE=MODE@ACTIVE:SURVEYING,TIME=1718052301.25";
+    NodeReportFields fields;
+    if (!scanNodeReport(report, fields)) return false;
+    if (test_verbose > 0) std::cout << "Scanned: " << fields.name << " (" << fields.x << "," << fields.y << ") hdg=" << fields.hdg << std::endl;
+    if (fields.name != "abe") return false;
+    if (!fields.has_x || !isClose(fields.x, 47.59)) return false;
+    if (!fields.has_y || !isClose(fields.y, -49.46)) return false;
+    if (!fields.has_hdg || !isClose(fields.hdg, 122.11)) return false;
+    if (!fields.has_spd || !isClose(fields.spd, 1.12)) return false;
+    if (!fields.has_time || !isClose(fields.time, 1718052301.25)) return false;
+    if (fields.x_str != "47.59" || fields.y_str != "-49.46") return false;
+
+    // Field order should not matter, and missing fields are flagged
+    if (!scanNodeReport("TYPE=KAYAK,Y=2,NAME=ben", fields)) return false;
+    if (fields.name != "ben" || fields.has_x || !fields.has_y || fields.has_hdg || fields.has_time) return false;
+
+    // Bad numbers are flagged rather than thrown
+    if (!scanNodeReport("NAME=cal,X=12abc,Y=nan", fields)) return false;
+    if (fields.has_x || fields.has_y) return false;
+
+    // No name means no report
+    if (scanNodeReport("X=1,Y=2", fields)) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_scanNodeReport()" << std::endl;
+    return true;
+}
+
 bool test_processNodeReports(int test_verbose = 0) {
     if (test_verbose > 0) std::cout << "Start --- test_processNodeReports()" << std::endl;
     // Set up dirs
     std::string base = "../resources/test";
     std::string alog_dir = base+"/alog.test";
-    std::string out_csv_dir = base+"/temp.csv";
-    std::string exp_csv_dir = base+"/expected.csv";
+    std::string out_csv_dir = base+"/temp_positions";
+    std::string out_csv = out_csv_dir+"/abe_positions.csv";
+    std::string exp_csv = base+"/expected_abe_positions.csv";
+    std::filesystem::create_directories(out_csv_dir);
 
-    // Process node reports into csv
-    if (!processNodeReports(alog_dir, out_csv_dir)) return false;
+    // Process node reports into one csv (and binary twin) per vehicle
+    if (!processNodeReports(alog_dir, out_csv_dir, true)) return false;
 
     // Read back in the csv and check that it matches what we expect
-    if (!csvFilesAreEqual(out_csv_dir, exp_csv_dir, test_verbose)) return false;
+    bool equal = csvFilesAreEqual(out_csv, exp_csv, test_verbose);
+
+    // The binary twin should hold the same rows, in time order
+    PositionFile positions;
+    std::ifstream csv(out_csv);
+    std::string row;
+    std::getline(csv, row);
+    if (!positions.open(out_csv_dir+"/abe_positions.bin")) equal = false;
+    for (size_t i = 0; equal && std::getline(csv, row); i++) {
+        std::vector<std::string> cols = parseString(row, ',');
+        if (i >= positions.size() || cols.size() != 5) { equal = false; break; }
+        const PositionRecord& rec = positions[i];
+        if (!isClose(rec.time, std::stod(cols[0])) || !isClose(rec.x, std::stod(cols[1])) ||
+            !isClose(rec.y, std::stod(cols[2])))
+            equal = false;
+        if (cols[3].empty() ? !std::isnan(rec.hdg) : !isClose(rec.hdg, std::stod(cols[3])))
+            equal = false;
+        if (i > 0 && positions.lowerBound(rec.time) > i) equal = false;
+    }
+    if (equal && positions.size() > 0) {
+        if (positions.lowerBound(positions[0].time - 1) != 0) equal = false;
+        if (positions.lowerBound(positions[positions.size() - 1].time + 1) != positions.size()) equal = false;
+    }
 
-    // Remove the generated csv file
-    bool delete_flag = std::filesystem::remove(out_csv_dir);
+    // Remove the generated csv files
+    std::error_code ec;
+    bool delete_flag = std::filesystem::remove_all(out_csv_dir, ec) > 0;
     if (test_verbose > 0) {
         if (delete_flag) {
-            std::cout << "Succesfully deleted temporary file: " << out_csv_dir << std::endl;
+            std::cout << "Succesfully deleted temporary dir: " << out_csv_dir << std::endl;
         } else {
-            std::cout << "Error deleting temporary file: " << out_csv_dir << std::endl;
+            std::cout << "Error deleting temporary dir: " << out_csv_dir << std::endl;
         }
     }
+    if (!equal) return false;
+
+    // A missing log is an error
+    if (processNodeReports(base+"/missing.alog", out_csv_dir)) return false;
 
     if (test_verbose > 0) std::cout << "Finish --- test_processNodeReports()" << std::endl;
     return true;
 }
 
+bool test_processNodeReportJobs(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_processNodeReportJobs()" << std::endl;
+    std::string base = "../resources/test";
+    std::filesystem::path sweep = std::filesystem::temp_directory_path() / "test_node_report_jobs";
+    std::filesystem::remove_all(sweep);
+
+    // Three trials, each with a shoreside log and a vehicle log to ignore
+    for (int trial = 0; trial < 3; trial++) {
+        std::filesystem::path dir = sweep / ("trial_" + std::to_string(trial));
+        std::filesystem::create_directories(dir / "LOG_SHORESIDE");
+        std::filesystem::create_directories(dir / "LOG_ABE");
+        std::filesystem::copy_file(base + "/alog.test", dir / "LOG_SHORESIDE" / "LOG_SHORESIDE.alog");
+        std::filesystem::copy_file(base + "/alog.test", dir / "LOG_ABE" / "LOG_ABE.alog");
+    }
+
+    std::vector<NodeReportJob> jobs = findNodeReportJobs(sweep.string());
+    if (jobs.size() != 3) return false;
+    if (!processNodeReportJobs(jobs, 2)) return false;
+    for (const NodeReportJob& job : jobs) {
+        if (job.skipped) return false;
+        if (!csvFilesAreEqual(job.out_dir + "/abe_positions.csv", base + "/expected_abe_positions.csv", test_verbose))
+            return false;
+    }
+
+    // Nothing changed, so a second pass skips every log
+    jobs = findNodeReportJobs(sweep.string());
+    if (!processNodeReportJobs(jobs, 2)) return false;
+    for (const NodeReportJob& job : jobs)
+        if (!job.skipped) return false;
+
+    // A stamp from an older output format is out of date
+    std::string stamp_path = jobs[0].out_dir + "/.node_reports_stamp";
+    std::string stamp;
+    {
+        std::ifstream in(stamp_path);
+        if (!std::getline(in, stamp) || stamp.compare(0, 4, "fmt=") != 0) return false;
+    }
+    {
+        std::ofstream out(stamp_path);
+        out << stamp.substr(stamp.find(',') + 1) << "\n";
+    }
+    jobs = findNodeReportJobs(sweep.string());
+    if (!processNodeReportJobs(jobs, 2)) return false;
+    if (jobs[0].skipped || !jobs[1].skipped) return false;
+
+    // Forcing converts every log again, up to date or not
+    jobs = findNodeReportJobs(sweep.string());
+    unsigned int reported = 0;
+    if (!processNodeReportJobs(jobs, 2, true, [&](const NodeReportJob&) { reported++; })) return false;
+    if (reported != 3 || jobs[0].skipped) return false;
+
+    // A forced run that fails partway drops the stamp, so the next run
+    // converts that log again rather than trusting its truncated outputs
+    std::filesystem::path blocked = std::filesystem::path(jobs[1].out_dir) / "abe_positions.csv";
+    std::filesystem::remove(blocked);
+    std::filesystem::create_directory(blocked);
+    jobs = findNodeReportJobs(sweep.string());
+    if (processNodeReportJobs(jobs, 2, true)) return false;
+    if (jobs[1].ok || std::filesystem::exists(jobs[1].out_dir + "/.node_reports_stamp")) return false;
+    std::filesystem::remove(blocked);
+    jobs = findNodeReportJobs(sweep.string());
+    if (!processNodeReportJobs(jobs, 2)) return false;
+    if (jobs[1].skipped || !jobs[0].skipped) return false;
+
+    std::filesystem::remove_all(sweep);
+    if (test_verbose > 0) std::cout << "Finish --- test_processNodeReportJobs()" << std::endl;
+    return true;
+}
+
+bool test_csvFilterDuplicateRows(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_csvFilterDuplicateRows()" << std::endl;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string in_csv = (dir / "test_filter_in.csv").string();
+    std::string out_csv = (dir / "test_filter_out.csv").string();
+    {
+        std::ofstream in(in_csv);
+        in << "x,y\n1,2\n1,2\n1,2\n3,4\n1,2\n5,6\n5,6\n3,4";  // no final newline
+    }
+
+    auto readAll = [](const std::string& path) {
+        std::ifstream in(path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    };
+
+    if (!csvFilterDuplicateRows(in_csv, out_csv, test_verbose)) return false;
+    if (readAll(out_csv) != "x,y\n1,2\n3,4\n5,6\n") return false;
+
+    if (!csvFilterDuplicateRows(in_csv, out_csv, test_verbose, DuplicateFilterMode::Fingerprint)) return false;
+    if (readAll(out_csv) != "x,y\n1,2\n3,4\n5,6\n") return false;
+
+    if (!csvFilterDuplicateRows(in_csv, out_csv, test_verbose, DuplicateFilterMode::Consecutive)) return false;
+    if (readAll(out_csv) != "x,y\n1,2\n3,4\n1,2\n5,6\n3,4\n") return false;
+
+    // Filtering a file onto itself is refused
+    if (csvFilterDuplicateRows(in_csv, in_csv, test_verbose)) return false;
+
+    std::filesystem::remove(in_csv);
+    std::filesystem::remove(out_csv);
+    if (test_verbose > 0) std::cout << "Finish --- test_csvFilterDuplicateRows()" << std::endl;
+    return true;
+}
+
+bool test_csvMergeFiles(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_csvMergeFiles()" << std::endl;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "test_csv_merge";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    auto writeFile = [&](const std::string& name, const std::string& text) {
+        std::ofstream out(dir / name);
+        out << text;
+    };
+    auto readAll = [&](const std::string& name) {
+        std::ifstream in(dir / name);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    };
+
+    // Files are appended in name order, blank lines dropped and ends stripped
+    writeFile("ben_positions.csv", "x,y\n3,4\n\n  5,6 \r\n");
+    writeFile("abe_positions.csv", "x,y\n1,2\n");
+    writeFile("cal_positions.csv", "7,8\n");  // no header
+    if (!csvMergeFiles(dir.string())) return false;
+    if (readAll("team_positions.csv") != "x,y\n1,2\n3,4\n5,6\n7,8\n") return false;
+
+    if (!csvMergeFiles(dir.string(), {"ben"})) return false;
+    if (readAll("team_positions_without_ben.csv") != "x,y\n1,2\n7,8\n") return false;
+
+    // No time column to merge by
+    if (csvMergeFiles(dir.string(), {}, true)) return false;
+
+    // Interleave by time, ties going to the earlier file
+    std::filesystem::remove(dir / "cal_positions.csv");
+    writeFile("abe_positions.csv", "time,x,y\n0.0,1,1\n1.0,1,2\n3.0,1,3\n");
+    writeFile("ben_positions.csv", "time,x,y\n0.5,2,1\n1.0,2,2\n2.0,2,3\n4.0,2,4\n");
+    if (!csvMergeFiles(dir.string(), {}, true)) return false;
+    std::string expected = "time,x,y\n0.0,1,1\n0.5,2,1\n1.0,1,2\n1.0,2,2\n2.0,2,3\n3.0,1,3\n4.0,2,4\n";
+    if (readAll("team_positions.csv") != expected) return false;
+
+    // Files larger than the block a reader keeps in memory. The header
+    // and rows in released pages still read back.
+    std::string abe_text = "time,x,y\n";
+    std::string ben_text = "time,x,y\n";
+    std::string big_expected = "time,x,y\n";
+    for (int i = 0; i < 100000; i++) {
+        std::string abe_row = std::to_string(2 * i) + ",1," + std::to_string(i) + "\n";
+        std::string ben_row = std::to_string(2 * i + 1) + ",2," + std::to_string(i) + "\n";
+        abe_text += abe_row;
+        ben_text += ben_row;
+        big_expected += abe_row + ben_row;
+    }
+    writeFile("abe_positions.csv", abe_text);
+    writeFile("ben_positions.csv", ben_text);
+    if (!csvMergeFiles(dir.string(), {}, true)) return false;
+    if (readAll("team_positions.csv") != big_expected) return false;
+
+    // Headers have to agree
+    writeFile("ben_positions.csv", "x,y\n3,4\n");
+    if (csvMergeFiles(dir.string())) return false;
+
+    std::filesystem::remove_all(dir);
+    if (test_verbose > 0) std::cout << "Finish --- test_csvMergeFiles()" << std::endl;
+    return true;
+}
+
+bool test_PolygonGrid(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_PolygonGrid()" << std::endl;
+    // U shape opening upward, the notch spans x=[20,40], y=[20,60]
+    std::vector<double> xs = {0, 60, 60, 40, 40, 20, 20, 0};
+    std::vector<double> ys = {0, 0, 60, 60, 20, 20, 60, 60};
+
+    PolygonGrid grid;
+    if (grid.contains(10, 10)) return false;  // empty grid
+    if (!grid.build(xs, ys, 0.0, 16)) return false;
+
+    // Hand-picked points
+    if (!grid.contains(10, 10)) return false;   // bottom bar
+    if (!grid.contains(50, 50)) return false;   // right arm
+    if (grid.contains(30, 40)) return false;    // inside the notch
+    if (grid.contains(-5, 30)) return false;    // left of the shape
+    if (grid.contains(1000, 1000)) return false;
+
+    // A 6m buffer closes the 20m wide notch up to 6m from its walls
+    if (!grid.build(xs, ys, 6.0, 16)) return false;
+    if (!grid.contains(25, 40)) return false;
+    if (grid.contains(30, 40)) return false;
+    if (!grid.contains(-5, 30)) return false;
+    if (grid.contains(-7, 30)) return false;
+
+    // Compare against the per-edge test over a cloud of points
+    unsigned int seed = 12345;
+    for (double offset : {0.0, 3.5, 12.0}) {
+        if (!grid.build(xs, ys, offset, 32)) return false;
+        for (int i = 0; i < 20000; i++) {
+            seed = seed * 1103515245u + 12345u;
+            double x = -20.0 + 100.0 * ((seed >> 8) % 100000) / 100000.0;
+            seed = seed * 1103515245u + 12345u;
+            double y = -20.0 + 100.0 * ((seed >> 8) % 100000) / 100000.0;
+            if (grid.contains(x, y) != grid.containsExact(x, y)) {
+                if (test_verbose > 0) std::cout << "Mismatch at (" << x << "," << y << ") offset " << offset << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if (test_verbose > 0) std::cout << "Finish --- test_PolygonGrid()" << std::endl;
+    return true;
+}
+
+bool test_TrajectoryStore(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_TrajectoryStore()" << std::endl;
+    std::string path = (std::filesystem::temp_directory_path() / "test_trajectory_store.bin").string();
+
+    TrajectoryStore store;
+    uint32_t abe = store.entityId("abe", TrajectoryStore::VEHICLE);
+    if (store.entityId("abe", TrajectoryStore::VEHICLE) != abe) return false;
+
+    // Enough samples to span a chunk boundary, flushed in two parts
+    size_t first_half = TrajectoryStore::CHUNK_SIZE - 10;
+    for (size_t i = 0; i < first_half; i++)
+        store.append(abe, i * 0.5, i, -1.0 * i, 90.0);
+    if (!store.flush(path)) return false;
+    uint64_t first_size = store.bytesFlushed();
+
+    uint32_t ben = store.entityId("ben", TrajectoryStore::VEHICLE);
+    uint32_t swimmer = store.entityId("swimmer_7", TrajectoryStore::SWIMMER);
+    store.append(swimmer, 3.0, 40.0, -20.0, 0.0);
+    for (size_t i = first_half; i < first_half + 30; i++) {
+        store.append(abe, i * 0.5, i, -1.0 * i, 90.0);
+        store.append(ben, i * 0.5, 2.0 * i, 5.0, 180.0);
+    }
+    store.addRescue(42.0, swimmer, ben);
+    if (!store.flush(path)) return false;
+    if (store.bytesFlushed() <= first_size) return false;
+    if (test_verbose > 0) std::cout << "Flushed " << store.bytesFlushed() << " bytes" << std::endl;
+
+    TrajectoryStore loaded;
+    if (!loaded.load(path)) return false;
+    std::filesystem::remove(path);
+
+    if (loaded.numEntities() != 3) return false;
+    if (loaded.totalSamples() != store.totalSamples()) return false;
+    for (uint32_t id = 0; id < store.numEntities(); id++) {
+        if (loaded.name(id) != store.name(id) || loaded.kind(id) != store.kind(id)) return false;
+        if (loaded.numSamples(id) != store.numSamples(id)) return false;
+        for (size_t i = 0; i < store.numSamples(id); i++) {
+            if (loaded.time(id, i) != store.time(id, i) || loaded.x(id, i) != store.x(id, i) ||
+                loaded.y(id, i) != store.y(id, i) || loaded.hdg(id, i) != store.hdg(id, i))
+                return false;
+        }
+    }
+    if (loaded.numSamples(abe) != first_half + 30) return false;
+    if (loaded.x(abe, TrajectoryStore::CHUNK_SIZE + 5) != TrajectoryStore::CHUNK_SIZE + 5) return false;
+    if (loaded.rescues().size() != 1) return false;
+    if (loaded.rescues()[0].finder != ben || loaded.rescues()[0].time != 42.0) return false;
+
+    // Not a store file
+    if (loaded.load("../resources/test/expected.csv")) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_TrajectoryStore()" << std::endl;
+    return true;
+}
+
+bool test_CoverageGrid(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_CoverageGrid()" << std::endl;
+    // 100x100 square with 10m cells
+    XYPolygon region;
+    region.add_vertex(0, 0);
+    region.add_vertex(100, 0);
+    region.add_vertex(100, 100);
+    region.add_vertex(0, 100);
+
+    CoverageGrid abe, ben;
+    if (abe.add(5, 5)) return false;  // no region yet
+    if (!abe.setRegion(region, 10) || !ben.setRegion(region, 10)) return false;
+    if (abe.cols() != 10 || abe.rows() != 10 || abe.regionCells() != 100) return false;
+
+    if (!abe.add(5, 5)) return false;
+    if (abe.add(6, 6)) return false;        // same cell again
+    if (!abe.add(55, 95)) return false;
+    if (abe.add(150, 50)) return false;     // outside
+    if (abe.cellsVisited() != 2 || abe.count(0, 0) != 2) return false;
+
+    ben.add(5, 5);
+    ben.add(95, 5);
+    CoverageGrid team = abe;
+    if (!team.merge(ben)) return false;
+    if (team.cellsVisited() != 3 || team.count(0, 0) != 3) return false;
+    if (!isClose(team.coverage(), 0.03)) return false;
+
+    // Different grids cannot be merged
+    CoverageGrid coarse;
+    coarse.setRegion(region, 20);
+    if (team.merge(coarse)) return false;
+
+    // Round trip through the binary form
+    std::string path = (std::filesystem::temp_directory_path() / "test_coverage_grid.bin").string();
+    if (!team.save(path)) return false;
+    CoverageGrid loaded;
+    if (!loaded.load(path)) return false;
+    std::filesystem::remove(path);
+    if (loaded.cols() != team.cols() || loaded.rows() != team.rows()) return false;
+    if (loaded.regionCells() != team.regionCells() || loaded.cellsVisited() != team.cellsVisited()) return false;
+    for (unsigned int row = 0; row < team.rows(); row++)
+        for (unsigned int col = 0; col < team.cols(); col++)
+            if (loaded.count(col, row) != team.count(col, row)) return false;
+    if (!loaded.merge(team) || loaded.count(0, 0) != 6) return false;
+
+    if (test_verbose > 0) std::cout << "Team coverage: " << team.coverage() << std::endl;
+    if (test_verbose > 0) std::cout << "Finish --- test_CoverageGrid()" << std::endl;
+    return true;
+}
+
+bool test_ScoreEngine(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_ScoreEngine()" << std::endl;
+    // 100x100 square with 10m cells
+    XYPolygon region;
+    region.add_vertex(0, 0);
+    region.add_vertex(100, 0);
+    region.add_vertex(100, 100);
+    region.add_vertex(0, 100);
+
+    ScoreEngine score;
+    score.setCellSize(10);
+    score.setRegion(region);
+    score.addSwimmer();
+    score.addSwimmer();
+    score.addSwimmer();
+
+    // abe goes 30m east then 40m north, ben 10m north over abe's first cell
+    score.addPosition("abe", 5, 5);
+    score.addPosition("abe", 35, 5);
+    score.addPosition("abe", 35, 45);
+    score.addPosition("ben", 5, 5);
+    score.addPosition("ben", 5, 15);
+    if (!isClose(score.teamPathLength(), 80)) return false;
+    if (!isClose(score.vehicles().at("abe").path_length, 70)) return false;
+    if (score.vehicles().at("abe").coverage.cellsVisited() != 3) return false;
+    if (!isClose(score.teamCoverage(), 0.04)) return false;
+
+    // A rescue without a seen alert counts, but not towards time-to-rescue
+    score.addRescue("abe", 100, 60);
+    score.addRescue("ben", 130, 70);
+    score.addRescue("ben", 140, -1);
+    if (score.teamRescues() != 3 || score.vehicles().at("ben").rescues != 2) return false;
+    if (!isClose(score.meanTimeToRescue(), 50)) return false;
+    if (!isClose(ScoreEngine::meanTimeToRescue(score.vehicles().at("ben")), 60)) return false;
+
+    if (!score.changed()) return false;
+    std::string spec = score.getSpec();
+    if (test_verbose > 0) std::cout << "Spec: " << spec << std::endl;
+    if (tokStringParse(spec, "rescues", ',', '=') != "3" || tokStringParse(spec, "swimmers", ',', '=') != "3") return false;
+    if (!isClose(atof(tokStringParse(spec, "mean_ttr", ',', '=').c_str()), 50)) return false;
+    if (!isClose(atof(tokStringParse(spec, "coverage", ',', '=').c_str()), 0.04)) return false;
+    if (!isClose(atof(tokStringParse(spec, "path_len", ',', '=').c_str()), 80)) return false;
+    if (score.changed()) return false;
+
+    // Reporting the same position again changes nothing reported
+    score.addPosition("ben", 5, 15);
+    if (score.changed()) return false;
+    score.addPosition("ben", 5, 16);
+    if (!score.changed()) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_ScoreEngine()" << std::endl;
+    return true;
+}
+
+bool test_SwimmerRecorder(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_SwimmerRecorder()" << std::endl;
+    TrajectoryStore store;
+    ScoreEngine score;
+    SwimmerRecorder recorder(store, score);
+
+    // Alerted then rescued: one sample from the alert, timed to the rescue
+    if (!recorder.addAlert(1, "01", 10, 20, -30)) return false;
+    if (recorder.addAlert(1, "01", 11, 99, 99)) return false;  // repeated alert
+    if (!recorder.addRescue(1, "01", 50, "abe")) return false;
+    if (recorder.addRescue(1, "01", 51, "abe")) return false;
+
+    // Rescued before its alert: counted once, and the late alert still
+    // gives it a position and a sample
+    if (!recorder.addRescue(7, "07", 60, "ben")) return false;
+    if (!recorder.addAlert(7, "07", 62, 5, 6)) return false;
+    if (recorder.addAlert(7, "07", 63, 5, 6)) return false;
+
+    const SwimmerStore& swimmers = recorder.swimmers();
+    if (swimmers.size() != 2 || swimmers.numRescued() != 2) return false;
+    if (!swimmers.hasPosition(7) || !isClose(swimmers.x(7), 5) || !isClose(swimmers.y(7), 6)) return false;
+    uint32_t late = store.entityId("swimmer_07", TrajectoryStore::SWIMMER);
+    if (store.numSamples(late) != 1 || !isClose(store.time(late, 0), 62)) return false;
+    if (score.swimmers() != 2 || score.teamRescues() != 2 || store.rescues().size() != 2) return false;
+
+    // Only the rescue that followed its alert has a time-to-rescue
+    if (!isClose(ScoreEngine::meanTimeToRescue(score.vehicles().at("abe")), 40)) return false;
+    if (score.vehicles().at("ben").ttr_count != 0) return false;
+    if (!isClose(score.meanTimeToRescue(), 40)) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_SwimmerRecorder()" << std::endl;
+    return true;
+}
+
+bool test_SwimFieldGenerator(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_SwimFieldGenerator()" << std::endl;
+    std::vector<double> xs, ys;
+    if (!parsePolyPoints("pts={60,10:-75.5402,-54.2561:-36.9866,-135.58:98.5536,-71.3241}", xs, ys)) return false;
+    if (xs.size() != 4 || !isClose(xs[1], -75.5402) || !isClose(ys[2], -135.58)) return false;
+    std::vector<double> bad_xs, bad_ys;
+    if (parsePolyPoints("1,2:3", bad_xs, bad_ys)) return false;
+
+    PolygonGrid region;
+    region.build(xs, ys, 0);
+
+    SwimFieldGenerator generator;
+    if (!generator.setRegion(xs, ys)) return false;
+    generator.setSeparation(10);
+
+    // Loose enough for random placement, and tight enough to need a full fill
+    unsigned int counts[2][2] = {{9, 9}, {80, 0}};
+    for (auto& count : counts) {
+        SwimScenario first, second;
+        if (!generator.generate(count[0], count[1], 7, first)) return false;
+        if (!generator.generate(count[0], count[1], 7, second)) return false;
+        if (formatSwimFile(first) != formatSwimFile(second)) return false;
+
+        if (first.swimmers.size() != count[0] + count[1]) return false;
+        for (const SwimmerSpec& swimmer : first.swimmers)
+            if (!region.containsExact(swimmer.x, swimmer.y)) return false;
+        if (minSwimmerSeparation(first) < 10) return false;
+        if (test_verbose > 0) std::cout << count[0] + count[1] << " swimmers, lowest dist "
+                                        << minSwimmerSeparation(first) << std::endl;
+    }
+
+    SwimScenario scenario;
+    generator.generate(2, 1, 3, scenario);
+    if (scenario.swimmers[1].name != "p02" || scenario.swimmers[2].name != "x01") return false;
+    if (scenario.swimmers[2].type != "unreg") return false;
+    SwimScenario other;
+    generator.generate(2, 1, 4, other);
+    if (formatSwimFile(scenario) == formatSwimFile(other)) return false;
+
+    // Far more than fit at this separation
+    if (generator.generate(500, 0, 7, scenario)) return false;
+
+    SwimScenario small;
+    small.swimmers.push_back({"p01", "", 1.25, -0.04});
+    std::string text = formatSwimFile(small, "made by hand");
+    if (text != "// made by hand\nswimmer = name=p01, x=1.2, y=0\n") return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_SwimFieldGenerator()" << std::endl;
+    return true;
+}
+
+bool test_parseSwimFile(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_parseSwimFile()" << std::endl;
+    std::string text =
+        "// gen_swimmers --pav90 --swimmers=2 --sep=5\n"
+        "poly = pts={60,10:-75.5402,-54.2561:-36.9866,-135.58}\r\n"
+        "\n"
+        "swimmer = name=p01, x=64.7, y=-39.7\n"
+        "  swimmer = type=unreg, name=x01,x=4.7,y=-99.4, color=red\n"
+        "show_swimmers = true\n";
+    SwimScenario scenario;
+    if (!parseSwimFile(text, scenario)) return false;
+    if (scenario.poly_xs.size() != 3 || !isClose(scenario.poly_ys[1], -54.2561)) return false;
+    if (scenario.swimmers.size() != 2) return false;
+    const SwimmerSpec& second = scenario.swimmers[1];
+    if (second.name != "x01" || second.type != "unreg" || !isClose(second.x, 4.7) || !isClose(second.y, -99.4))
+        return false;
+    if (scenario.swimmers[0].name != "p01" || !scenario.swimmers[0].type.empty()) return false;
+
+    // Reading back a generated file gives the same scenario
+    SwimFieldGenerator generator;
+    generator.setRegion(scenario.poly_xs, scenario.poly_ys);
+    generator.setSeparation(5);
+    SwimScenario generated, loaded;
+    if (!generator.generate(10, 5, 11, generated)) return false;
+    std::string path = (std::filesystem::temp_directory_path() / "test_swim_file.txt").string();
+    if (!writeSwimFile(path, generated, "round trip")) return false;
+    if (!loadSwimFile(path, loaded)) return false;
+    std::filesystem::remove(path);
+    if (formatSwimFile(loaded) != formatSwimFile(generated)) return false;
+
+    unsigned int bad_line = 0;
+    if (parseSwimFile("poly = pts={0,0:1,0:1,1}\nswimmer = name=p01, x=3\n", scenario, &bad_line)) return false;
+    if (bad_line != 2) return false;
+    if (loadSwimFile("../resources/test/missing_swim_file.txt", scenario, &bad_line) || bad_line != 0) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_parseSwimFile()" << std::endl;
+    return true;
+}
+
+bool test_SwimmerStore(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_SwimmerStore()" << std::endl;
+    SwimmerStore store;
+    if (store.has(1) || store.rescued(1) || store.size() != 0) return false;
+
+    if (!store.add(1, 10, -20)) return false;
+    if (!store.add(3, 30, -40)) return false;
+    if (store.add(1, 99, 99)) return false;  // first position is kept
+    if (!store.has(1) || store.has(2) || !store.hasPosition(3)) return false;
+    if (!isClose(store.x(1), 10) || !isClose(store.y(1), -20)) return false;
+
+    // Rescue reported before the alert
+    if (!store.setRescued(70)) return false;
+    if (store.setRescued(70)) return false;
+    if (!store.has(70) || store.hasPosition(70) || !store.rescued(70)) return false;
+    if (!store.add(70, 5, 5) || !store.rescued(70)) return false;
+    if (!store.setRescued(3)) return false;
+    if (store.size() != 3 || store.numRescued() != 2 || store.endId() <= 70) return false;
+
+    std::vector<uint32_t> active;
+    store.forEachActive([&](uint32_t id, double, double) { active.push_back(id); });
+    if (active.size() != 1 || active[0] != 1) return false;
+
+    if (store.add(SwimmerStore::MAX_ID, 0, 0) || store.setRescued(SwimmerStore::MAX_ID)) return false;
+    store.clear();
+    if (store.has(1) || store.size() != 0 || store.numRescued() != 0) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_SwimmerStore()" << std::endl;
+    return true;
+}
+
+bool test_VehicleTable(int test_verbose = 0) {
+    if (test_verbose > 0) std::cout << "Start --- test_VehicleTable()" << std::endl;
+    VehicleTable table;
+    table.setStaleTime(5);
+    uint32_t abe = table.update("abe", 100, 0, 0, 2, 90);  // east at 2 m/s
+    uint32_t ben = table.update("ben", 100, 10, 10, 1, 0); // north at 1 m/s
+    if (abe != 0 || ben != 1 || table.size() != 2) return false;
+    if (table.update("abe", 101, 2, 0, 2, 90) != abe || table.size() != 2) return false;
+    if (!isClose(table.x(abe), 2) || !isClose(table.time(abe), 101) || table.name(ben) != "ben") return false;
+
+    // Without dead reckoning, reported positions as they are
+    std::vector<double> xs, ys;
+    table.forEachCurrent(103, [&](uint32_t, double x, double y) { xs.push_back(x); ys.push_back(y); });
+    if (xs.size() != 2 || !isClose(xs[0], 2) || !isClose(ys[1], 10)) return false;
+
+    // Ben goes stale first; abe is moved on along its heading
+    table.setDeadReckoning(true);
+    xs.clear();
+    ys.clear();
+    table.forEachCurrent(105.5, [&](uint32_t, double x, double y) { xs.push_back(x); ys.push_back(y); });
+    if (xs.size() != 1 || !isClose(xs[0], 11) || !isClose(ys[0], 0, 1e-9, 1e-9)) return false;
+    if (table.numCurrent(105.5) != 1 || table.numCurrent(107) != 0) return false;
+
+    // Unknown speed or heading stays put
+    table.update("cal", 200, 5, 5);
+    xs.clear();
+    table.forEachCurrent(202, [&](uint32_t, double x, double) { xs.push_back(x); });
+    if (xs.size() != 1 || !isClose(xs[0], 5)) return false;
+
+    table.setStaleTime(0);
+    if (table.numCurrent(1000) != 3) return false;
+    table.clear();
+    if (table.size() != 0) return false;
+
+    if (test_verbose > 0) std::cout << "Finish --- test_VehicleTable()" << std::endl;
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     int TEST_VERBOSE = 0;
     if (argc >= 2) {
@@ -240,9 +917,64 @@ int main(int argc, char* argv[]) {
     if (!test_csvFilesAreEqual(TEST_VERBOSE)) std::cout << "FAILURE: test_csvFilesAreEqual" << std::endl;
     else std::cout << "PASSED: test_csvFilesAreEqual" << std::endl;
 
+    if (!test_csvFilesAreClose(TEST_VERBOSE)) std::cout << "FAILURE: test_csvFilesAreClose" << std::endl;
+    else std::cout << "PASSED: test_csvFilesAreClose" << std::endl;
+
+    // Test scanning node reports
+    if (!test_scanNodeReport(TEST_VERBOSE)) std::cout << "FAILURE: test_scanNodeReport" << std::endl;
+    else std::cout << "PASSED: test_scanNodeReport" << std::endl;
+
     // Test processing a shoreside log file
     if (!test_processNodeReports(TEST_VERBOSE)) std::cout << "FAILURE: test_processNodeReports" << std::endl;
     else std::cout << "PASSED: test_processNodeReports" << std::endl;
 
+    // Test converting many logs at once
+    if (!test_processNodeReportJobs(TEST_VERBOSE)) std::cout << "FAILURE: test_processNodeReportJobs" << std::endl;
+    else std::cout << "PASSED: test_processNodeReportJobs" << std::endl;
+
+    // Test removing duplicate rows in each mode
+    if (!test_csvFilterDuplicateRows(TEST_VERBOSE)) std::cout << "FAILURE: test_csvFilterDuplicateRows" << std::endl;
+    else std::cout << "PASSED: test_csvFilterDuplicateRows" << std::endl;
+
+    // Test merging position files
+    if (!test_csvMergeFiles(TEST_VERBOSE)) std::cout << "FAILURE: test_csvMergeFiles" << std::endl;
+    else std::cout << "PASSED: test_csvMergeFiles" << std::endl;
+
+    // Test the point-in-polygon grid
+    if (!test_PolygonGrid(TEST_VERBOSE)) std::cout << "FAILURE: test_PolygonGrid" << std::endl;
+    else std::cout << "PASSED: test_PolygonGrid" << std::endl;
+
+    // Test the trajectory store and its file format
+    if (!test_TrajectoryStore(TEST_VERBOSE)) std::cout << "FAILURE: test_TrajectoryStore" << std::endl;
+    else std::cout << "PASSED: test_TrajectoryStore" << std::endl;
+
+    // Test the coverage grid
+    if (!test_CoverageGrid(TEST_VERBOSE)) std::cout << "FAILURE: test_CoverageGrid" << std::endl;
+    else std::cout << "PASSED: test_CoverageGrid" << std::endl;
+
+    // Test the running mission score
+    if (!test_ScoreEngine(TEST_VERBOSE)) std::cout << "FAILURE: test_ScoreEngine" << std::endl;
+    else std::cout << "PASSED: test_ScoreEngine" << std::endl;
+
+    // Test recording swimmer alerts and rescues in either order
+    if (!test_SwimmerRecorder(TEST_VERBOSE)) std::cout << "FAILURE: test_SwimmerRecorder" << std::endl;
+    else std::cout << "PASSED: test_SwimmerRecorder" << std::endl;
+
+    // Test generating swim files
+    if (!test_SwimFieldGenerator(TEST_VERBOSE)) std::cout << "FAILURE: test_SwimFieldGenerator" << std::endl;
+    else std::cout << "PASSED: test_SwimFieldGenerator" << std::endl;
+
+    // Test reading swim files
+    if (!test_parseSwimFile(TEST_VERBOSE)) std::cout << "FAILURE: test_parseSwimFile" << std::endl;
+    else std::cout << "PASSED: test_parseSwimFile" << std::endl;
+
+    // Test the id-indexed swimmer store
+    if (!test_SwimmerStore(TEST_VERBOSE)) std::cout << "FAILURE: test_SwimmerStore" << std::endl;
+    else std::cout << "PASSED: test_SwimmerStore" << std::endl;
+
+    // Test the vehicle table used for vehicle sensing
+    if (!test_VehicleTable(TEST_VERBOSE)) std::cout << "FAILURE: test_VehicleTable" << std::endl;
+    else std::cout << "PASSED: test_VehicleTable" << std::endl;
+
     // Test trimming down csv files
 }
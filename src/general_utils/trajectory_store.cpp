@@ -0,0 +1,188 @@
+#include "trajectory_store.h"
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+// File layout (native byte order, little-endian on all our targets):
+//   header: "TRJS" magic, uint32 version
+//   then any number of blocks, each starting with a one byte tag:
+//     'E' entity:  uint32 id, uint8 kind, uint16 name length, name bytes
+//     'S' samples: uint32 id, uint32 count, then count times, count x,
+//                  count y and count headings (doubles)
+//     'R' rescue:  double time, uint32 swimmer id, uint32 finder id
+// Entities are always written before any samples or rescues using them.
+
+static const char STORE_MAGIC[4] = {'T', 'R', 'J', 'S'};
+static const uint32_t STORE_VERSION = 1;
+
+template <typename T>
+static void writeRaw(std::ofstream& out, const T& val) {
+    out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+static bool readRaw(std::ifstream& in, T& val) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&val), sizeof(T)));
+}
+
+uint32_t TrajectoryStore::entityId(const std::string& name, EntityKind kind) {
+    std::unordered_map<std::string, uint32_t>::const_iterator it = m_entity_ids.find(name);
+    if (it != m_entity_ids.end()) return it->second;
+
+    uint32_t id = m_entities.size();
+    m_entities.emplace_back();
+    m_entities.back().name = name;
+    m_entities.back().kind = kind;
+    m_entity_ids[name] = id;
+    return id;
+}
+
+uint32_t TrajectoryStore::findEntity(const std::string& name) const {
+    std::unordered_map<std::string, uint32_t>::const_iterator it = m_entity_ids.find(name);
+    return (it == m_entity_ids.end()) ? NO_ENTITY : it->second;
+}
+
+void TrajectoryStore::append(uint32_t entity, double time, double x, double y, double hdg) {
+    Entity& ent = m_entities[entity];
+    size_t slot = ent.size % CHUNK_SIZE;
+    if (slot == 0) ent.chunks.emplace_back(new Chunk);
+
+    Chunk& chunk = *ent.chunks.back();
+    chunk.time[slot] = time;
+    chunk.x[slot] = x;
+    chunk.y[slot] = y;
+    chunk.hdg[slot] = hdg;
+    ent.size++;
+}
+
+void TrajectoryStore::addRescue(double time, uint32_t swimmer, uint32_t finder) {
+    m_rescues.push_back({time, swimmer, finder});
+}
+
+void TrajectoryStore::clear() {
+    m_entities.clear();
+    m_entity_ids.clear();
+    m_rescues.clear();
+    m_entities_flushed = 0;
+    m_rescues_flushed = 0;
+    m_file_started = false;
+    m_bytes_flushed = 0;
+}
+
+size_t TrajectoryStore::totalSamples() const {
+    size_t total = 0;
+    for (const Entity& ent : m_entities) total += ent.size;
+    return total;
+}
+
+void TrajectoryStore::markAllFlushed() {
+    for (Entity& ent : m_entities) ent.flushed = ent.size;
+    m_entities_flushed = m_entities.size();
+    m_rescues_flushed = m_rescues.size();
+}
+
+bool TrajectoryStore::flush(const std::string& path) {
+    std::ios::openmode mode = std::ios::binary | (m_file_started ? std::ios::app : std::ios::trunc);
+    std::ofstream out(path, mode);
+    if (!out.is_open()) return false;
+
+    if (!m_file_started) {
+        out.write(STORE_MAGIC, sizeof(STORE_MAGIC));
+        writeRaw(out, STORE_VERSION);
+    }
+
+    for (size_t id = m_entities_flushed; id < m_entities.size(); id++) {
+        const Entity& ent = m_entities[id];
+        uint16_t len = std::min<size_t>(ent.name.size(), 0xFFFF);
+        out.put('E');
+        writeRaw(out, (uint32_t)id);
+        writeRaw(out, (uint8_t)ent.kind);
+        writeRaw(out, len);
+        out.write(ent.name.data(), len);
+    }
+
+    // One sample block per chunk touched, so each column is contiguous
+    for (size_t id = 0; id < m_entities.size(); id++) {
+        const Entity& ent = m_entities[id];
+        size_t i = ent.flushed;
+        while (i < ent.size) {
+            const Chunk& chunk = *ent.chunks[i / CHUNK_SIZE];
+            size_t first = i % CHUNK_SIZE;
+            uint32_t count = std::min(CHUNK_SIZE - first, ent.size - i);
+            out.put('S');
+            writeRaw(out, (uint32_t)id);
+            writeRaw(out, count);
+            out.write(reinterpret_cast<const char*>(chunk.time + first), count * sizeof(double));
+            out.write(reinterpret_cast<const char*>(chunk.x + first), count * sizeof(double));
+            out.write(reinterpret_cast<const char*>(chunk.y + first), count * sizeof(double));
+            out.write(reinterpret_cast<const char*>(chunk.hdg + first), count * sizeof(double));
+            i += count;
+        }
+    }
+
+    for (size_t r = m_rescues_flushed; r < m_rescues.size(); r++) {
+        out.put('R');
+        writeRaw(out, m_rescues[r].time);
+        writeRaw(out, m_rescues[r].swimmer);
+        writeRaw(out, m_rescues[r].finder);
+    }
+
+    out.close();
+    if (out.fail()) return false;
+    std::error_code ec;
+    m_bytes_flushed = std::filesystem::file_size(path, ec);
+    m_file_started = true;
+    markAllFlushed();
+    return true;
+}
+
+bool TrajectoryStore::load(const std::string& path) {
+    clear();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[sizeof(STORE_MAGIC)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), STORE_MAGIC))
+        return false;
+    if (!readRaw(in, version) || version != STORE_VERSION) return false;
+
+    std::vector<double> cols;
+    char tag;
+    while (in.get(tag)) {
+        if (tag == 'E') {
+            uint32_t id;
+            uint8_t kind;
+            uint16_t len;
+            if (!readRaw(in, id) || !readRaw(in, kind) || !readRaw(in, len)) return false;
+            std::string name(len, '\0');
+            if (!in.read(&name[0], len)) return false;
+            if (id != m_entities.size()) return false;
+            entityId(name, kind == SWIMMER ? SWIMMER : VEHICLE);
+        }
+        else if (tag == 'S') {
+            uint32_t id, count;
+            if (!readRaw(in, id) || !readRaw(in, count)) return false;
+            if (id >= m_entities.size() || count > CHUNK_SIZE) return false;
+            cols.resize(4 * (size_t)count);
+            if (!in.read(reinterpret_cast<char*>(cols.data()), cols.size() * sizeof(double)))
+                return false;
+            for (uint32_t i = 0; i < count; i++)
+                append(id, cols[i], cols[count + i], cols[2 * count + i], cols[3 * count + i]);
+        }
+        else if (tag == 'R') {
+            RescueEvent event;
+            if (!readRaw(in, event.time) || !readRaw(in, event.swimmer) || !readRaw(in, event.finder))
+                return false;
+            if (event.swimmer >= m_entities.size()) return false;
+            if (event.finder != NO_ENTITY && event.finder >= m_entities.size()) return false;
+            m_rescues.push_back(event);
+        }
+        else {
+            return false;
+        }
+    }
+
+    // A later flush() starts a new file holding everything loaded here
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef TRAJECTORY_STORE_H
+#define TRAJECTORY_STORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+// In-memory, append-only record of everything that moved during a mission.
+// Each entity (vehicle or swimmer) keeps its samples as separate time, x,
+// y and heading columns, stored in fixed-size chunks so appending never
+// copies old samples. Rescues go in their own event table.
+//
+// flush() appends whatever is new since the last flush to a binary file,
+// so a long mission can be saved every few seconds without rewriting it.
+// load() reads such a file back for scoring after the mission.
+class TrajectoryStore {
+  public:
+    enum EntityKind : uint8_t { VEHICLE = 0, SWIMMER = 1 };
+
+    static const uint32_t NO_ENTITY = 0xFFFFFFFF;
+    static const size_t CHUNK_SIZE = 1024;
+
+    struct RescueEvent {
+        double time;
+        uint32_t swimmer;  // entity id of the swimmer
+        uint32_t finder;   // entity id of the vehicle, or NO_ENTITY
+    };
+
+    TrajectoryStore() {}
+
+    // Get the id of an entity, adding it if it is new
+    uint32_t entityId(const std::string& name, EntityKind kind);
+    // Id of an existing entity, or NO_ENTITY
+    uint32_t findEntity(const std::string& name) const;
+
+    void append(uint32_t entity, double time, double x, double y, double hdg);
+    void addRescue(double time, uint32_t swimmer, uint32_t finder = NO_ENTITY);
+
+    void clear();
+
+    size_t numEntities() const { return m_entities.size(); }
+    const std::string& name(uint32_t entity) const { return m_entities[entity].name; }
+    EntityKind kind(uint32_t entity) const { return m_entities[entity].kind; }
+    size_t numSamples(uint32_t entity) const { return m_entities[entity].size; }
+    size_t totalSamples() const;
+
+    // Column access, i in [0, numSamples(entity))
+    double time(uint32_t entity, size_t i) const { return chunk(entity, i).time[i % CHUNK_SIZE]; }
+    double x(uint32_t entity, size_t i) const { return chunk(entity, i).x[i % CHUNK_SIZE]; }
+    double y(uint32_t entity, size_t i) const { return chunk(entity, i).y[i % CHUNK_SIZE]; }
+    double hdg(uint32_t entity, size_t i) const { return chunk(entity, i).hdg[i % CHUNK_SIZE]; }
+
+    const std::vector<RescueEvent>& rescues() const { return m_rescues; }
+
+    // Append everything added since the last flush to path. The first
+    // flush (or the first after clear/load) truncates the file and writes
+    // the header and all data. Returns false if the file could not be
+    // written.
+    bool flush(const std::string& path);
+
+    // Replace the contents of this store with a file written by flush()
+    bool load(const std::string& path);
+
+    // Size of the file after the last flush()
+    uint64_t bytesFlushed() const { return m_bytes_flushed; }
+
+  private:
+    struct Chunk {
+        double time[CHUNK_SIZE];
+        double x[CHUNK_SIZE];
+        double y[CHUNK_SIZE];
+        double hdg[CHUNK_SIZE];
+    };
+
+    struct Entity {
+        std::string name;
+        EntityKind kind = VEHICLE;
+        size_t size = 0;
+        size_t flushed = 0;  // samples already written to file
+        std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    const Chunk& chunk(uint32_t entity, size_t i) const {
+        return *m_entities[entity].chunks[i / CHUNK_SIZE];
+    }
+    void markAllFlushed();
+
+  private:
+    std::vector<Entity> m_entities;
+    std::unordered_map<std::string, uint32_t> m_entity_ids;
+    std::vector<RescueEvent> m_rescues;
+
+    size_t m_entities_flushed = 0;
+    size_t m_rescues_flushed = 0;
+    bool m_file_started = false;
+    uint64_t m_bytes_flushed = 0;
+};
+
+#endif // TRAJECTORY_STORE_H
@@ -0,0 +1,64 @@
+#include "vehicle_table.h"
+
+VehicleTable::VehicleTable() {
+    m_stale_time = 0;
+    m_dead_reckon = false;
+}
+
+uint32_t VehicleTable::update(std::string_view name, double time, double x, double y,
+                              double spd, double hdg) {
+    // Vehicle names are short enough that this key stays off the heap
+    std::string key(name);
+    std::unordered_map<std::string, uint32_t>::iterator it = m_index.find(key);
+    uint32_t ix;
+    if (it != m_index.end()) {
+        ix = it->second;
+    } else {
+        ix = (uint32_t)m_names.size();
+        m_index.emplace(key, ix);
+        m_names.push_back(key);
+        m_times.push_back(0);
+        m_xs.push_back(0);
+        m_ys.push_back(0);
+        m_vxs.push_back(0);
+        m_vys.push_back(0);
+    }
+
+    m_times[ix] = time;
+    m_xs[ix] = x;
+    m_ys[ix] = y;
+    if (std::isfinite(spd) && std::isfinite(hdg)) {
+        double rad = hdg * M_PI / 180.0;
+        m_vxs[ix] = spd * std::sin(rad);
+        m_vys[ix] = spd * std::cos(rad);
+    } else {
+        m_vxs[ix] = 0;
+        m_vys[ix] = 0;
+    }
+    return ix;
+}
+
+void VehicleTable::clear() {
+    m_index.clear();
+    m_names.clear();
+    m_times.clear();
+    m_xs.clear();
+    m_ys.clear();
+    m_vxs.clear();
+    m_vys.clear();
+}
+
+size_t VehicleTable::numCurrent(double now) const {
+    size_t count = 0;
+    for (uint32_t ix = 0; ix < m_names.size(); ix++)
+        if (!isStale(ix, now)) count++;
+    return count;
+}
+
+void VehicleTable::extrapolate(uint32_t ix, double now, double& px, double& py) const {
+    // Never run backwards, e.g. for a report stamped slightly ahead of now
+    double dt = now - m_times[ix];
+    if (dt <= 0) return;
+    px += m_vxs[ix] * dt;
+    py += m_vys[ix] * dt;
+}
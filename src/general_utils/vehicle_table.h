@@ -0,0 +1,78 @@
+#ifndef VEHICLE_TABLE_H
+#define VEHICLE_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+// Latest reported state of each vehicle, in packed per-field arrays
+// indexed by a small integer. Names are only looked up when a report
+// arrives. Reading every vehicle is a linear scan that skips stale
+// entries and can dead-reckon each one forward to the current time.
+class VehicleTable {
+  public:
+    VehicleTable();
+
+    // Entries not updated for longer than this (seconds) are skipped.
+    // 0 or less keeps every entry.
+    void setStaleTime(double secs) { m_stale_time = secs; }
+    // Extrapolate positions along the reported heading at the reported
+    // speed, up to the current time
+    void setDeadReckoning(bool on) { m_dead_reckon = on; }
+    double staleTime() const { return m_stale_time; }
+    bool deadReckoning() const { return m_dead_reckon; }
+
+    // Update a vehicle in place, adding it if new. hdg is in degrees,
+    // clockwise from north. Pass NaN for an unknown speed or heading.
+    // Returns the vehicle's index.
+    uint32_t update(std::string_view name, double time, double x, double y,
+                    double spd = NAN, double hdg = NAN);
+
+    void clear();
+
+    size_t size() const { return m_names.size(); }
+    const std::string& name(uint32_t ix) const { return m_names[ix]; }
+    double time(uint32_t ix) const { return m_times[ix]; }
+    double x(uint32_t ix) const { return m_xs[ix]; }
+    double y(uint32_t ix) const { return m_ys[ix]; }
+
+    bool isStale(uint32_t ix, double now) const {
+        return (m_stale_time > 0) && (now - m_times[ix] > m_stale_time);
+    }
+    // Vehicles that are not stale at time now
+    size_t numCurrent(double now) const;
+
+    // Call f(ix, x, y) for each vehicle that is not stale at time now,
+    // with its position extrapolated to now if dead reckoning is on
+    template <typename F>
+    void forEachCurrent(double now, F f) const {
+        for (uint32_t ix = 0; ix < m_names.size(); ix++) {
+            if (isStale(ix, now)) continue;
+            double px = m_xs[ix];
+            double py = m_ys[ix];
+            if (m_dead_reckon) extrapolate(ix, now, px, py);
+            f(ix, px, py);
+        }
+    }
+
+  private:
+    void extrapolate(uint32_t ix, double now, double& px, double& py) const;
+
+    double m_stale_time;
+    bool m_dead_reckon;
+
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<std::string> m_names;
+    std::vector<double> m_times;
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+    // Velocity east/north from the reported speed and heading, 0 if
+    // either is unknown
+    std::vector<double> m_vxs;
+    std::vector<double> m_vys;
+};
+
+#endif // VEHICLE_TABLE_H
@@ -7,6 +7,11 @@
 
 #include "ivp_behavior_extend.h"
 
+IvPBehaviorExtend::IvPBehaviorExtend(IvPDomain domain) : IvPBehavior(domain) {
+  // Only posted by pSectorSense in lockstep mode
+  addInfoVars("SECTOR_SENSOR_STEP", "no_warning");
+}
+
 bool IvPBehaviorExtend::setVecDoubleOnString(std::vector<double> given_vec_double, const std::string& str) {
   double temp_dbl;
   bool good_reading;
@@ -50,3 +55,12 @@ bool IvPBehaviorExtend::setVecIntOnString(std::vector<int> given_vec_int, const
   }
   return true;
 }
+
+void IvPBehaviorExtend::postLockstepDecision() {
+  // SECTOR_SENSOR_STEP is posted after its step's reading, so the step
+  // read here is never ahead of the reading the decision came from
+  bool ok = false;
+  double step = getBufferDoubleVal("SECTOR_SENSOR_STEP", ok);
+  if(ok)
+    postMessage("LOCKSTEP_DECISION", step);
+}
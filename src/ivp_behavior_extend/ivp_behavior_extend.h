@@ -21,12 +21,19 @@
 // as class methods
 class IvPBehaviorExtend : public IvPBehavior {
 public:
-    IvPBehaviorExtend(IvPDomain domain) : IvPBehavior(domain) {}
+    IvPBehaviorExtend(IvPDomain domain);
     virtual ~IvPBehaviorExtend() {}
 
     // New methods
     bool setVecDoubleOnString(std::vector<double> given_vec_double, const std::string& str);
     bool setVecIntOnString(std::vector<int> given_vec_int, const std::string& str);
+
+protected:
+    // In lockstep mode, echo the step of the sector reading a decision
+    // was just built from. Call only from onRunState() once an IvP
+    // function has been built, so pSectorSense acks steps the helm
+    // actually decided on.
+    void postLockstepDecision();
 };
 
 #endif
\ No newline at end of file
@@ -17,7 +17,7 @@ using namespace std;
 // Constructor
 
 BHV_FollowCOM::BHV_FollowCOM(IvPDomain domain) :
-  IvPBehavior(domain)
+  IvPBehaviorExtend(domain)
 {
   // Provide a default behavior name
   IvPBehavior::setParam("name", "defaultname");
@@ -217,6 +217,8 @@ IvPFunction* BHV_FollowCOM::onRunState()
   IvPFunction *ipf = buildFunction();
   postEventMessage("Built the IvP function.");
 
+  if(ipf)
+    postLockstepDecision();
   return(ipf);
 }
 
@@ -10,13 +10,13 @@
 
 #include <string>
 #include <cmath>
-#include "IvPBehavior.h"
+#include "ivp_behavior_extend.h"
 #include "ZAIC_PEAK.h"
 #include "OF_Coupler.h"
 #include "AngleUtils.h"
 #include "general_utils.h"
 
-class BHV_FollowCOM : public IvPBehavior {
+class BHV_FollowCOM : public IvPBehaviorExtend {
 public:
   BHV_FollowCOM(IvPDomain);
   ~BHV_FollowCOM() {};
@@ -17,7 +17,7 @@ using namespace std;
 // Constructor
 
 BHV_MaxReading::BHV_MaxReading(IvPDomain domain) :
-  IvPBehavior(domain)
+  IvPBehaviorExtend(domain)
 {
   // Provide a default behavior name
   IvPBehavior::setParam("name", "defaultname");
@@ -191,6 +191,8 @@ IvPFunction* BHV_MaxReading::onRunState()
   IvPFunction *ipf = buildFunction();
   postEventMessage("Built the IvP function.");
 
+  if(ipf)
+    postLockstepDecision();
   return(ipf);
 }
 
@@ -10,13 +10,13 @@
 
 #include <string>
 #include <cmath>
-#include "IvPBehavior.h"
+#include "ivp_behavior_extend.h"
 #include "ZAIC_PEAK.h"
 #include "OF_Coupler.h"
 #include "AngleUtils.h"
 #include "general_utils.h"
 
-class BHV_MaxReading : public IvPBehavior {
+class BHV_MaxReading : public IvPBehaviorExtend {
 public:
   BHV_MaxReading(IvPDomain);
   ~BHV_MaxReading() {};
@@ -18,7 +18,7 @@ using namespace std;
 // Constructor
 
 BHV_Neural_Network::BHV_Neural_Network(IvPDomain domain) :
-  IvPBehavior(domain)
+  IvPBehaviorExtend(domain)
 {
   // Provide a default behavior name
   IvPBehavior::setParam("name", "defaultname");
@@ -110,7 +110,7 @@ void BHV_Neural_Network::onSetParamComplete()
   std::vector<double> weights;
   string warning;
   bool good_reading;
-  good_reading = setVecDoubleOnString(weights, lines[0], warning);
+  good_reading = ::setVecDoubleOnString(weights, lines[0], warning);
   if(!good_reading) {
     postWMessage("Failed to read neural network weights. Bad reading for line 0 of file: " + m_csv_directory + ". " + warning);
     m_initialization_failed = true;
@@ -126,7 +126,7 @@ void BHV_Neural_Network::onSetParamComplete()
   // from line 1. These define the structure of the neural network
   std::vector<int> structure;
   warning = "";
-  good_reading = setVecIntOnString(structure, lines[1], warning);
+  good_reading = ::setVecIntOnString(structure, lines[1], warning);
   if(!good_reading) {
     postWMessage("Failed to read neural network structure. Bad reading for line 1 of file: " + m_csv_directory + ". " + warning);
     m_initialization_failed = true;
@@ -152,7 +152,7 @@ void BHV_Neural_Network::onSetParamComplete()
   // Get the output bounds of the neural network from
   // line 2. These define the output boundaries of the network
   std::vector<double> bounds_flat;
-  good_reading = setVecDoubleOnString(bounds_flat, lines[2], warning);
+  good_reading = ::setVecDoubleOnString(bounds_flat, lines[2], warning);
   warning = "";
   if(!good_reading) {
     postWMessage("Failed to read neural network bounds. Bad reading for line 2 of file: " + m_csv_directory + ". " + warning);
@@ -276,6 +276,8 @@ IvPFunction* BHV_Neural_Network::onRunState()
   IvPFunction *ipf = buildFunction();
   postEventMessage("Built the IvP function.");
 
+  if(ipf)
+    postLockstepDecision();
   return(ipf);
 }
 
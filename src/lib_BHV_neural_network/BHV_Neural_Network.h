@@ -9,7 +9,7 @@
 #define Neural_Network_HEADER
 
 #include <string>
-#include "IvPBehavior.h"
+#include "ivp_behavior_extend.h"
 #include "network.h"
 #include "ZAIC_PEAK.h"
 #include "OF_Coupler.h"
@@ -26,7 +26,7 @@
 //     velocity action is irrespective of current velocity. Velocity of 1.0 means change the velocity to 1.0, not add 1.0 to current velocity.
 //     heading is relative to current heading. Relative heading of +0.5 means add 0.5 to current heading.
 
-class BHV_Neural_Network : public IvPBehavior {
+class BHV_Neural_Network : public IvPBehaviorExtend {
 public:
   BHV_Neural_Network(IvPDomain);
   ~BHV_Neural_Network() {};
@@ -10,6 +10,7 @@
 #pragma warning(disable : 4503)
 #endif
 #include <math.h> 
+#include <algorithm>
 #include "AOF_SimpleWaypoint.h"
 #include "AngleUtils.h"
 #include "GeomUtils.h"
@@ -26,6 +27,16 @@ AOF_SimpleWaypoint::AOF_SimpleWaypoint(IvPDomain g_domain) : AOF(g_domain)
   m_max_speed    = 0;
   m_angle_to_wpt = 0;
 
+  // Grid layout and tables, set in initialize
+  m_crs_ix      = -1;
+  m_spd_ix      = -1;
+  m_crs_low     = 0;
+  m_crs_delta   = 0;
+  m_crs_points  = 0;
+  m_spd_delta   = 0;
+  m_spd_points  = 0;
+  m_grid_cached = false;
+
   // Initialization parameters
   m_osx         = 0;  // ownship x-position 
   m_osy         = 0;  // ownship y-position
@@ -91,15 +102,125 @@ bool AOF_SimpleWaypoint::initialize()
   m_min_speed = m_domain.getVarLow("speed");
   m_max_speed = m_domain.getVarHigh("speed");
 
+  m_crs_ix     = m_domain.getIndex("course");
+  m_spd_ix     = m_domain.getIndex("speed");
+  m_crs_low    = m_domain.getVarLow("course");
+  m_crs_delta  = m_domain.getVarDelta("course");
+  m_crs_points = m_domain.getVarPoints("course");
+  m_spd_delta  = m_domain.getVarDelta("speed");
+  m_spd_points = m_domain.getVarPoints("speed");
+
+  // The only parts of the score that depend on course, one entry per
+  // course in the domain, computed as evalPoint does
+  m_cos_table.resize(m_crs_points);
+  m_detour_table.resize(m_crs_points);
+  for(unsigned int i=0; i<m_crs_points; i++) {
+    double eval_crs   = m_crs_low + (i * m_crs_delta);
+    double angle_diff = angle360(eval_crs - m_angle_to_wpt);
+    m_cos_table[i] = cos(degToRadians(angle_diff));
+    double angle_180 = angle180(angle_diff);
+    if(angle_180 < 0)
+      angle_180 *= -1;
+    m_detour_table[i] = angle_180;
+  }
+
+  m_grid_values.clear();
+  m_grid_cached = false;
+
+  return(true);
+}
+
+//----------------------------------------------------------------
+// Procedure: evalGrid
+//   Purpose: Evaluate the whole decision grid. The speed terms are
+//            tabled once, and the inner loop over speeds is straight
+//            line arithmetic on arrays so the compiler vectorizes it.
+
+bool AOF_SimpleWaypoint::evalGrid(vector<double>& values) const
+{
+  if((m_crs_points == 0) || (m_spd_points == 0))
+    return(false);
+
+  double roc_range = 2 * m_max_speed;
+  double rod_range = (m_max_speed * 180);
+  double spd_range = m_max_speed - m_desired_spd;
+  if((m_desired_spd - m_min_speed) > spd_range)
+    spd_range = m_desired_spd - m_min_speed;
+
+  // Per speed: the raw speed (rate of closure uses it unclamped), the
+  // speed clamped at zero, and the weighted speed score
+  vector<double> spd_vals(m_spd_points);
+  vector<double> spd_pos(m_spd_points);
+  vector<double> spd_score(m_spd_points);
+  for(unsigned int j=0; j<m_spd_points; j++) {
+    double eval_spd = m_min_speed + (j * m_spd_delta);
+    spd_vals[j] = eval_spd;
+    if(eval_spd < 0)
+      eval_spd = 0;
+    spd_pos[j] = eval_spd;
+    double spd_diff = m_desired_spd - eval_spd;
+    if(spd_diff < 0)
+      spd_diff *= -1;
+    if(spd_diff > spd_range)
+      spd_diff = spd_range;
+    spd_score[j] = 0.05 * ((1.0 - (spd_diff / spd_range)) * 100);
+  }
+
+  // Locals rather than members, so the stores into values can't alias
+  // them and the inner loop vectorizes
+  unsigned int  spd_points  = m_spd_points;
+  double        desired_spd = m_desired_spd;
+  const double* spd   = spd_vals.data();
+  const double* pos   = spd_pos.data();
+  const double* score = spd_score.data();
+
+  values.resize(m_crs_points * spd_points);
+  for(unsigned int i=0; i<m_crs_points; i++) {
+    double  cos_diff = m_cos_table[i];
+    double  detour   = m_detour_table[i];
+    double* row      = &values[i * spd_points];
+
+    for(unsigned int j=0; j<spd_points; j++) {
+      // max/min rather than ifs, so there is no branch. Being over the
+      // desired rate of closure is penalized half as much.
+      double roc_diff = desired_spd - (cos_diff * spd[j]);
+      roc_diff = max(roc_diff, roc_diff * -0.5);
+      roc_diff = min(roc_diff, roc_range);
+      double score_roc = (1.0 - (roc_diff / roc_range)) * 100;
+      double score_rod = (1.0 - ((detour * pos[j]) / rod_range)) * 100;
+
+      row[j] = ((0.75 * score_roc) + (0.2 * score_rod)) + score[j];
+    }
+  }
   return(true);
 }
 
+//----------------------------------------------------------------
+// Procedure: cacheGrid
+
+bool AOF_SimpleWaypoint::cacheGrid()
+{
+  m_grid_cached = evalGrid(m_grid_values);
+  return(m_grid_cached);
+}
+
 //----------------------------------------------------------------
 // Procedure: evalPoint
 //   Purpose: Evaluate a candidate point in the decision space
 
 double AOF_SimpleWaypoint::evalPoint(const vector<double>& point) const
 {
+  // Look grid points up in the cached table
+  if(m_grid_cached) {
+    double crs_ix = (point[m_crs_ix] - m_crs_low) / m_crs_delta;
+    double spd_ix = (point[m_spd_ix] - m_min_speed) / m_spd_delta;
+    long   ci = lround(crs_ix);
+    long   si = lround(spd_ix);
+    if((ci >= 0) && (ci < (long)m_crs_points) && (fabs(crs_ix - ci) < 1e-6) &&
+       (si >= 0) && (si < (long)m_spd_points) && (fabs(spd_ix - si) < 1e-6))
+      return(m_grid_values[(ci * m_spd_points) + si]);
+  }
+
   // Determine the course and speed being evaluated
   double eval_crs = extract("course", point);
   double eval_spd = extract("speed", point);
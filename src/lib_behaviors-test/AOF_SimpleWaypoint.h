@@ -8,6 +8,7 @@
 #ifndef AOF_SIMPLE_WAYPOINT_HEADER
 #define AOF_SIMPLE_WAYPOINT_HEADER
 
+#include <vector>
 #include "AOF.h"
 #include "IvPDomain.h"
 
@@ -21,6 +22,20 @@ public: // virtuals defined
   bool   setParam(const std::string&, double);
   bool   initialize();
 
+public:
+  // Evaluate every point of the course x speed grid at once, course
+  // major: values[(crs_ix * spd_points) + spd_ix]. Same scores as
+  // evalPoint, with the per-course trig done once per course.
+  bool   evalGrid(std::vector<double>& values) const;
+
+  // Fill a table with evalGrid so later evalPoint calls on grid
+  // points (all a reflector makes) are lookups
+  bool   cacheGrid();
+
+  // Score of a grid point by index, valid after cacheGrid
+  double gridValue(unsigned int crs_ix, unsigned int spd_ix) const
+    {return(m_grid_values[(crs_ix * m_spd_points) + spd_ix]);}
+
 protected:
   // Initialization parameters
   double m_osx;   // Ownship x position at time Tm.
@@ -40,6 +55,22 @@ protected:
   double m_angle_to_wpt;
   double m_min_speed;
   double m_max_speed;
+
+  // Decision grid layout, set in initialize
+  int          m_crs_ix;
+  int          m_spd_ix;
+  double       m_crs_low;
+  double       m_crs_delta;
+  unsigned int m_crs_points;
+  double       m_spd_delta;
+  unsigned int m_spd_points;
+
+  // Per-course cos and |angle180| of the angle to the waypoint
+  std::vector<double> m_cos_table;
+  std::vector<double> m_detour_table;
+
+  std::vector<double> m_grid_values;
+  bool                m_grid_cached;
 };
 
 #endif
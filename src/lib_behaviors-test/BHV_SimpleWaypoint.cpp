@@ -22,6 +22,7 @@
 
 #include <cstdlib>
 #include <math.h>
+#include <chrono>
 #include "BHV_SimpleWaypoint.h"
 #include "MBUtils.h"
 #include "AngleUtils.h"
@@ -29,6 +30,7 @@
 #include "ZAIC_PEAK.h"
 #include "OF_Coupler.h"
 #include "OF_Reflector.h"
+#include "PDMap.h"
 #include "AOF_SimpleWaypoint.h"
 
 using namespace std;
@@ -48,10 +50,20 @@ BHV_SimpleWaypoint::BHV_SimpleWaypoint(IvPDomain gdomain) :
   m_arrival_radius = 10;
   m_ipf_type       = "zaic";
 
+  // Adaptive reflector defaults: the same 1100 pieces the fixed
+  // reflector uses at most, in AOF utility units (0-100)
+  m_adaptive_tolerance      = 1.0;
+  m_adaptive_uniform_pieces = 100;
+  m_adaptive_max_pieces     = 1100;
+  m_adaptive_time_budget    = 0;   // seconds, 0 for no limit
+
   // Default values for behavior state variables
   m_osx  = 0;
   m_osy  = 0;
 
+  // Start at the full budget, clamped on the first build
+  m_adaptive_smart_pieces = m_adaptive_max_pieces;
+
   addInfoVars("NAV_X, NAV_Y");
 }
 
@@ -82,11 +94,28 @@ bool BHV_SimpleWaypoint::setParam(string param, string val)
   }
   else if(param == "ipf_type") {
     val = tolower(val);
-    if((val == "zaic") || (val == "reflector")) {
+    if((val == "zaic") || (val == "reflector") || (val == "adaptive")) {
       m_ipf_type = val;
       return(true);
     }
   }
+  else if((param == "adaptive_tolerance") && (double_val > 0) && (isNumber(val))) {
+    m_adaptive_tolerance = double_val;
+    return(true);
+  }
+  else if((param == "adaptive_uniform_pieces") && (double_val >= 1) && (isNumber(val))) {
+    m_adaptive_uniform_pieces = (unsigned int)(double_val);
+    return(true);
+  }
+  else if((param == "adaptive_max_pieces") && (double_val >= 1) && (isNumber(val))) {
+    m_adaptive_max_pieces   = (unsigned int)(double_val);
+    m_adaptive_smart_pieces = m_adaptive_max_pieces;
+    return(true);
+  }
+  else if((param == "adaptive_time_budget") && (double_val >= 0) && (isNumber(val))) {
+    m_adaptive_time_budget = double_val;
+    return(true);
+  }
   return(false);
 }
 
@@ -150,6 +179,8 @@ IvPFunction *BHV_SimpleWaypoint::onRunState()
   IvPFunction *ipf = 0;
   if(m_ipf_type == "zaic")
     ipf = buildFunctionWithZAIC();
+  else if(m_ipf_type == "adaptive")
+    ipf = buildFunctionAdaptive();
   else
     ipf = buildFunctionWithReflector();
   if(ipf == 0)
@@ -204,7 +235,7 @@ IvPFunction *BHV_SimpleWaypoint::buildFunctionWithZAIC()
 
 IvPFunction *BHV_SimpleWaypoint::buildFunctionWithReflector()
 {
-  IvPFunction *ivp_function;
+  IvPFunction *ivp_function = 0;
 
   bool ok = true;
   AOF_SimpleWaypoint aof_wpt(m_domain);
@@ -215,6 +246,9 @@ IvPFunction *BHV_SimpleWaypoint::buildFunctionWithReflector()
   ok = ok && aof_wpt.setParam("pty", m_nextpt.y());
   ok = ok && aof_wpt.initialize();
   if(ok) {
+    // Evaluate the whole grid in one batch up front, so the reflector's
+    // samples are table lookups rather than full evaluations
+    aof_wpt.cacheGrid();
     OF_Reflector reflector(&aof_wpt);
     reflector.create(600, 500);
     ivp_function = reflector.extractIvPFunction();
@@ -222,3 +256,110 @@ IvPFunction *BHV_SimpleWaypoint::buildFunctionWithReflector()
 
   return(ivp_function);
 }
+
+//-----------------------------------------------------------
+// Procedure: buildFunctionAdaptive
+//   Purpose: Build with the reflector's smart refinement, which keeps
+//            splitting the worst-fit piece until none is off by more
+//            than the tolerance or the piece budget runs out. The
+//            budget carries over between iterations and is scaled
+//            to keep each build within the time budget.
+
+IvPFunction *BHV_SimpleWaypoint::buildFunctionAdaptive()
+{
+  AOF_SimpleWaypoint aof_wpt(m_domain);
+  bool ok = true;
+  ok = ok && aof_wpt.setParam("desired_speed", m_desired_speed);
+  ok = ok && aof_wpt.setParam("osx", m_osx);
+  ok = ok && aof_wpt.setParam("osy", m_osy);
+  ok = ok && aof_wpt.setParam("ptx", m_nextpt.x());
+  ok = ok && aof_wpt.setParam("pty", m_nextpt.y());
+  ok = ok && aof_wpt.initialize();
+  ok = ok && aof_wpt.cacheGrid();
+  if(!ok)
+    return(0);
+
+  unsigned int uniform_pieces = m_adaptive_uniform_pieces;
+  if(uniform_pieces > m_adaptive_max_pieces)
+    uniform_pieces = m_adaptive_max_pieces;
+  unsigned int max_smart = m_adaptive_max_pieces - uniform_pieces;
+  if(m_adaptive_smart_pieces > max_smart)
+    m_adaptive_smart_pieces = max_smart;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  OF_Reflector reflector(&aof_wpt);
+  reflector.create(uniform_pieces, m_adaptive_smart_pieces, m_adaptive_tolerance);
+  IvPFunction *ivp_function = reflector.extractIvPFunction(false);
+  double build_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  if(!ivp_function)
+    return(0);
+
+  // Error is measured against the raw AOF scores, so normalize after
+  double max_err  = 0;
+  double mean_err = 0;
+  measureFitError(aof_wpt, ivp_function, max_err, mean_err);
+  ivp_function->getPDMap()->normalize(0.0, 100.0);
+
+  // Fit next iteration's budget to the time budget: shrink in
+  // proportion when over, grow by a quarter when well under and
+  // the tolerance still wasn't met
+  if(m_adaptive_time_budget > 0) {
+    if(build_time > m_adaptive_time_budget)
+      m_adaptive_smart_pieces = (unsigned int)(m_adaptive_smart_pieces * 0.9 *
+                                               (m_adaptive_time_budget / build_time));
+    else if((build_time < (0.5 * m_adaptive_time_budget)) && (max_err > m_adaptive_tolerance)) {
+      unsigned int grown = m_adaptive_smart_pieces + (m_adaptive_smart_pieces / 4) + 1;
+      m_adaptive_smart_pieces = (grown > max_smart) ? max_smart : grown;
+    }
+  }
+
+  string report = "bhv=" + m_descriptor;
+  report += ",pieces=" + intToString(ivp_function->getPDMap()->size());
+  report += ",max_err=" + doubleToStringX(max_err, 3);
+  report += ",mean_err=" + doubleToStringX(mean_err, 3);
+  report += ",tolerance=" + doubleToStringX(m_adaptive_tolerance, 3);
+  report += ",build_ms=" + doubleToStringX(build_time * 1000, 2);
+  report += ",smart_budget=" + uintToString(m_adaptive_smart_pieces);
+  postMessage("WPT_IPF_REPORT", report);
+
+  return(ivp_function);
+}
+
+//-----------------------------------------------------------
+// Procedure: measureFitError
+//   Purpose: Compare each piece's linear function with the AOF's
+//            score at every grid point the piece covers. Pieces
+//            are in domain index coordinates, as the grid table is.
+
+void BHV_SimpleWaypoint::measureFitError(const AOF_SimpleWaypoint& aof,
+                                         IvPFunction *ipf,
+                                         double& max_err, double& mean_err)
+{
+  max_err  = 0;
+  mean_err = 0;
+
+  int crs_d = m_domain.getIndex("course");
+  int spd_d = m_domain.getIndex("speed");
+  int dim   = m_domain.size();
+
+  PDMap *pdmap = ipf->getPDMap();
+  double total_err = 0;
+  unsigned long points = 0;
+  for(int i=0; i<pdmap->size(); i++) {
+    const IvPBox *box = pdmap->bx(i);
+    double crs_wt = box->wt(crs_d);
+    double spd_wt = box->wt(spd_d);
+    double offset = box->wt(dim);
+    for(int c=box->pt(crs_d, 0); c<=box->pt(crs_d, 1); c++) {
+      for(int s=box->pt(spd_d, 0); s<=box->pt(spd_d, 1); s++) {
+        double err = fabs((crs_wt * c) + (spd_wt * s) + offset - aof.gridValue(c, s));
+        if(err > max_err)
+          max_err = err;
+        total_err += err;
+        points++;
+      }
+    }
+  }
+  if(points > 0)
+    mean_err = total_err / points;
+}
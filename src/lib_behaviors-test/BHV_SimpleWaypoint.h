@@ -27,6 +27,8 @@
 #include "IvPBehavior.h"
 #include "XYPoint.h"
 
+class AOF_SimpleWaypoint;
+
 class BHV_SimpleWaypoint : public IvPBehavior {
 public:
   BHV_SimpleWaypoint(IvPDomain);
@@ -40,6 +42,9 @@ protected:
   void         postViewPoint(bool viewable=true);
   IvPFunction* buildFunctionWithZAIC();
   IvPFunction* buildFunctionWithReflector();
+  IvPFunction* buildFunctionAdaptive();
+  void         measureFitError(const AOF_SimpleWaypoint&, IvPFunction*,
+                               double& max_err, double& mean_err);
 
 protected: // Configuration parameters
   double       m_arrival_radius;
@@ -47,9 +52,19 @@ protected: // Configuration parameters
   XYPoint      m_nextpt;
   std::string  m_ipf_type;
 
+  // ipf_type=adaptive: start from a coarse uniform cover and refine
+  // only pieces whose error exceeds the tolerance, within a piece
+  // budget that shrinks or grows to fit the time budget.
+  double       m_adaptive_tolerance;
+  unsigned int m_adaptive_uniform_pieces;
+  unsigned int m_adaptive_max_pieces;
+  double       m_adaptive_time_budget;
+
 protected: // State variables
   double   m_osx;
   double   m_osy;
+
+  unsigned int m_adaptive_smart_pieces;
 };
 
 #ifdef WIN32
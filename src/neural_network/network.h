@@ -80,6 +80,7 @@ class NeuralNetwork {
 private:
     std::vector<Layer> layers; // Each layer contains multiple nodes
     std::vector<std::vector<double>> m_bounds; // Bounds for final outputs
+    bool m_verbose = true; // Print debug output while loading and running
 
 public:
     // Constructor to initialize the network
@@ -92,6 +93,11 @@ public:
         initialize(weights, structure, bounds, err);
     }
 
+    // Turn the debug printing off for callers on a latency budget
+    void setVerbose(bool verbose) {
+        m_verbose = verbose;
+    }
+
     bool initialize(const std::vector<double>& weights, const std::vector<int>& structure, const std::vector<std::vector<double>>& bounds, std::string& err) {
         m_bounds = bounds;
         if (structure.size() < 3) {
@@ -116,9 +122,11 @@ public:
                 }
 
                 // Debug: Log weight allocation for each node
-                std::cout << "Allocating weights for node " << j + 1 << " in layer " << i + 1 << ": ";
-                for (size_t k = weight_index; k < weight_index + input_size; ++k) {
-                    std::cout << weights[k] << " ";
+                if (m_verbose) {
+                    std::cout << "Allocating weights for node " << j + 1 << " in layer " << i + 1 << ": ";
+                    for (size_t k = weight_index; k < weight_index + input_size; ++k) {
+                        std::cout << weights[k] << " ";
+                    }
                 }
 
                 // Correctly allocate weights for each node
@@ -142,7 +150,9 @@ public:
             return(false);
         }
 
-        std::cout << "Neural network initialized successfully." << std::endl;
+        if (m_verbose) {
+            std::cout << "Neural network initialized successfully." << std::endl;
+        }
 
         return(true);
     }
@@ -154,11 +164,13 @@ public:
         for (Layer& layer : layers) {
             current_inputs = layer.forward(current_inputs); // Outputs of the current layer become inputs for the next layer
             // Debug: Print current_inputs before applying bounds
-            std::cout << "Current inputs: ";
-            for (const double& input : current_inputs) {
-                std::cout << input << " ";
+            if (m_verbose) {
+                std::cout << "Current inputs: ";
+                for (const double& input : current_inputs) {
+                    std::cout << input << " ";
+                }
+                std::cout << std::endl;
             }
-            std::cout << std::endl;
         }
 
         // Apply bounds to the final outputs
@@ -20,7 +20,16 @@ using namespace std;
 //---------------------------------------------------------
 // Constructor()
 
-MissionMonitor::MissionMonitor() {}
+MissionMonitor::MissionMonitor()
+{
+  debug = false;
+  evaluation_area_offset = 0;
+  debug_log_size = 100;
+  agent_timeout = 0;
+
+  m_num_out = 0;
+  m_mission_evaluated = false;
+}
 
 //---------------------------------------------------------
 // Destructor
@@ -89,6 +98,9 @@ void MissionMonitor::updateMissionArea(CMOOSMsg &msg)
   // RESCUE_REGION format:
   // "pts={60,10:-75.5,-54.3:-37,-135.6:98.6,-71.3},edge_color=gray90,vertex_color=dodger_blue,vertex_size=5"
 
+  // The buffered polygon is only used for display, the expander needs a
+  // convex polygon
+  m_offset_poly.clear();
   if (m_original_poly.is_convex())
   {
     XYPolyExpander expander;
@@ -97,64 +109,75 @@ void MissionMonitor::updateMissionArea(CMOOSMsg &msg)
     m_offset_poly = expander.getBufferPoly(evaluation_area_offset);
     m_offset_poly.set_label("mission_monitor_offset_poly");
   }
+
+  // Containment checks go through a precomputed grid built from the
+  // original polygon, which also handles non-convex regions
+  m_region_grid.build(m_original_poly, evaluation_area_offset);
 }
 
 void MissionMonitor::updateAgents(CMOOSMsg &msg)
 {
   // Parse NODE_REPORT which contains all vehicle info
-  string node_report = msg.GetString();
-  // m_debug_messages += "Received NODE_REPORT: " + node_report + "\n";
-
   // NODE_REPORT format:
   // "NAME=abe,TYPE=KAYAK,TIME=1234,X=100,Y=200,SPD=2.5,HDG=45,..." Extract
-  // vehicle name, x, y from NODE_REPORT
-  string vname = "";
-  double x = 0, y = 0, hdg = 0;
-
-  vector<string> parts = parseString(node_report, ',');
-  for (const string &part : parts)
+  // vehicle name, x, y from NODE_REPORT. Scan the message's own string
+  // rather than a copy from GetString() since this runs for every report.
+  NodeReportFields fields;
+  if (!scanNodeReport(msg.m_sVal, fields) || !fields.has_x || !fields.has_y)
+    return;
+
+  string vname(fields.name);
+  double x = fields.x;
+  double y = fields.y;
+
+  // Update agent info
+  XYPoint position(x, y, 0.0);
+  bool in_area = m_region_grid.contains(x, y);
+
+  bool created = false;
+  std::unordered_map<std::string, Agent>::iterator it = m_agent_map.find(vname);
+  if (it == m_agent_map.end())
   {
-    vector<string> keyval = parseString(part, '=');
-    if (keyval.size() == 2)
-    {
-      if (keyval[0] == "NAME")
-        vname = keyval[1];
-      else if (keyval[0] == "X")
-        x = stod(keyval[1]);
-      else if (keyval[0] == "Y")
-        y = stod(keyval[1]);
-      else if (keyval[0] == "HDG")
-        hdg = stod(keyval[1]);
-    }
+    it = m_agent_map.emplace(vname, Agent(position)).first;
+    it->second.report_order =
+        m_report_order.insert(m_report_order.end(), vname);
+    created = true;
   }
-
-  if (!vname.empty())
+  else
   {
-    // Update agent info
-    XYPoint position(x, y, 0.0);
-    // bool in_area = isPointInMissionArea(position);
-    bool in_area = m_offset_poly.contains(position);
-
-    if (m_agent_map.count(vname) > 0)
-    {
-      m_agent_map[vname].position.set_vx(x);
-      m_agent_map[vname].position.set_vy(y);
-      m_agent_map[vname].out_of_bounds = !in_area;
-
-      m_debug_messages += "Updated agent " + vname + " at (" + to_string(x) +
-                          "," + to_string(y) + ") - " +
-                          (in_area ? "IN AREA" : "OUT OF BOUNDS") + "\n";
-    }
+    it->second.position.set_vx(x);
+    it->second.position.set_vy(y);
+    // Move to the back of the report order, re-adding it if it went stale
+    if (it->second.stale)
+      it->second.report_order =
+          m_report_order.insert(m_report_order.end(), vname);
     else
-    {
-      Agent new_agent(position);
-      new_agent.out_of_bounds = !in_area;
-      m_agent_map[vname] = new_agent;
+      m_report_order.splice(m_report_order.end(), m_report_order,
+                            it->second.report_order);
+  }
 
-      m_debug_messages += "Created new agent " + vname + " at (" +
-                          to_string(x) + "," + to_string(y) + ") - " +
-                          (in_area ? "IN AREA" : "OUT OF BOUNDS") + "\n";
-    }
+  // Keep the out-of-bounds count current on every transition
+  Agent &agent = it->second;
+  bool was_out = !created && agent.countsOut();
+  agent.out_of_bounds = !in_area;
+  agent.stale = false;
+  agent.last_report = msg.GetTime();
+  bool now_out = agent.countsOut();
+  if (now_out && !was_out)
+    m_num_out++;
+  else if (!now_out && was_out)
+    m_num_out--;
+
+  // Record the raw event, formatting is left to buildReport()
+  if (debug && m_debug_events.capacity() > 0)
+  {
+    AgentEvent &event = m_debug_events.push();
+    event.time = msg.GetTime();
+    event.vname = vname;
+    event.x = x;
+    event.y = y;
+    event.created = created;
+    event.in_area = in_area;
   }
 }
 
@@ -166,36 +189,59 @@ bool MissionMonitor::Iterate()
 {
   AppCastingMOOSApp::Iterate();
 
-  // Check all agents for out of bounds status
-  if (!m_agent_map.empty())
-  {
-    bool terminate = false;
-    bool all_out_of_bounds = true;
+  markStaleAgents();
+  checkTermination();
 
-    for (const std::pair<std::string, Agent> &entry : m_agent_map)
-    {
-      const std::string &agent_id = entry.first;
-      const Agent &agent = entry.second;
+  AppCastingMOOSApp::PostReport();
+  return (true);
+}
 
-      if (termination_condition == "any_out_of_bounds" && agent.out_of_bounds)
-      {
-        Notify("MISSION_EVALUATED", "true");
-        break;
-      }
-      else if (!agent.out_of_bounds)
-      {
-        all_out_of_bounds = false;
-      }
-    }
+//---------------------------------------------------------
+// Procedure: markStaleAgents()
+//            flag agents that have not reported within agent_timeout.
+//            Only the front of the report order can be stale, so this
+//            stops at the first agent that is still current.
 
-    if (termination_condition == "all_out_of_bounds" && all_out_of_bounds)
-    {
-      Notify("MISSION_EVALUATED", "true");
-    }
+void MissionMonitor::markStaleAgents()
+{
+  if (agent_timeout <= 0)
+    return;
+
+  while (!m_report_order.empty())
+  {
+    Agent &agent = m_agent_map[m_report_order.front()];
+    if ((m_curr_time - agent.last_report) <= agent_timeout)
+      break;
+
+    if (!agent.countsOut())
+      m_num_out++;
+    agent.stale = true;
+    m_report_order.pop_front();
   }
+}
 
-  AppCastingMOOSApp::PostReport();
-  return (true);
+//---------------------------------------------------------
+// Procedure: checkTermination()
+//            post MISSION_EVALUATED the first time the termination
+//            condition holds
+
+void MissionMonitor::checkTermination()
+{
+  if (m_mission_evaluated || m_agent_map.empty())
+    return;
+
+  bool terminate = false;
+  if (termination_condition == "any_out_of_bounds")
+    terminate = (m_num_out > 0);
+  else if (termination_condition == "all_out_of_bounds")
+    terminate = (m_num_out == m_agent_map.size());
+
+  if (terminate)
+  {
+    Notify("MISSION_EVALUATED", "true");
+    m_mission_evaluated = true;
+    reportEvent("Mission evaluated: " + termination_condition);
+  }
 }
 
 //---------------------------------------------------------
@@ -226,18 +272,32 @@ bool MissionMonitor::OnStartUp()
     }
     else if (param == "termination_condition")
     {
-      termination_condition = value;
-      handled = true;
+      termination_condition = tolower(value);
+      handled = (termination_condition == "any_out_of_bounds") ||
+                (termination_condition == "all_out_of_bounds");
     }
     else if (param == "evaluation_area_offset")
     {
       handled = setDoubleOnString(evaluation_area_offset, value);
     }
+    else if (param == "agent_timeout")
+    {
+      handled = setNonNegDoubleOnString(agent_timeout, value);
+    }
+    else if (param == "debug_log_size")
+    {
+      int size = 0;
+      handled = setIntOnString(size, value) && (size >= 0);
+      if (handled)
+        debug_log_size = size;
+    }
 
     if (!handled)
       reportUnhandledConfigWarning(orig);
   }
 
+  m_debug_events.setCapacity(debug_log_size);
+
   registerVariables();
   return (true);
 }
@@ -265,6 +325,10 @@ bool MissionMonitor::buildReport()
 
   m_msgs << "Debug mode: " << (debug ? "ON" : "OFF") << std::endl;
   m_msgs << "Number of agents tracked: " << m_agent_map.size() << std::endl;
+  m_msgs << "Out of bounds or stale: " << m_num_out << std::endl;
+  m_msgs << "Termination condition: " << termination_condition << std::endl;
+  m_msgs << "Mission evaluated: " << boolToString(m_mission_evaluated)
+         << std::endl;
   m_msgs << "Original poly: " << m_original_poly.get_spec(3) << std::endl;
   m_msgs << "Offset poly: " << m_offset_poly.get_spec(3) << std::endl;
   m_msgs << "--------------------------------------------" << endl;
@@ -285,6 +349,8 @@ bool MissionMonitor::buildReport()
       std::string id = entry.first;
       const Agent &agent = entry.second;
       string status = agent.out_of_bounds ? "OUT OF BOUNDS" : "IN AREA";
+      if (agent.stale)
+        status = "STALE";
       actab << id << agent.position.get_vx() << agent.position.get_vy()
             << status << agent.position.get_spec();
     }
@@ -292,15 +358,22 @@ bool MissionMonitor::buildReport()
     m_msgs << actab.getFormattedString() << endl;
   }
 
-  // Show debug messages if debug is enabled and there are messages
-  if (debug && !m_debug_messages.empty())
+  // Show the most recent agent updates if debug is enabled
+  if (debug && !m_debug_events.empty())
   {
     m_msgs << "--------------------------------------------" << endl;
-    m_msgs << "Debug Messages:" << endl;
-    m_msgs << m_debug_messages;
+    m_msgs << "Debug Messages (last " << m_debug_events.size() << " of "
+           << m_debug_events.total() << "):" << endl;
+    for (size_t i = 0; i < m_debug_events.size(); i++)
+    {
+      const AgentEvent &event = m_debug_events[i];
+      m_msgs << doubleToString(event.time, 2) << " "
+             << (event.created ? "Created new agent " : "Updated agent ")
+             << event.vname << " at (" << doubleToString(event.x, 2) << ","
+             << doubleToString(event.y, 2) << ") - "
+             << (event.in_area ? "IN AREA" : "OUT OF BOUNDS") << endl;
+    }
     m_msgs << "--------------------------------------------" << endl;
-    // Clear debug messages after displaying them
-    m_debug_messages.clear();
   }
 
   return (true);
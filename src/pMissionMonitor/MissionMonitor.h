@@ -18,14 +18,38 @@
 #include "XYPoint.h"
 #include "XYPolygon.h"
 #include "general_utils.h"
+#include "ring_buffer.h"
+#include "polygon_grid.h"
+
+#include <list>
 
 struct Agent
 {
   XYPoint position;
   bool out_of_bounds;
+  bool stale;              // No report within agent_timeout
+  double last_report;      // MOOS time of the latest NODE_REPORT
+  std::list<std::string>::iterator report_order; // Entry in m_report_order
   Agent()
-      : position(0.0, 0.0, 0.0), out_of_bounds(false) {} // Default constructor
-  Agent(const XYPoint &pos) : position(pos), out_of_bounds(false) {}
+      : position(0.0, 0.0, 0.0), out_of_bounds(false), stale(false),
+        last_report(0.0) {} // Default constructor
+  Agent(const XYPoint &pos)
+      : position(pos), out_of_bounds(false), stale(false), last_report(0.0) {}
+
+  // Stale agents count against the mission the same as ones out of bounds
+  bool countsOut() const { return out_of_bounds || stale; }
+};
+
+// One processed NODE_REPORT, kept for the debug section of the appcast.
+// Stored raw and only formatted when an appcast is built.
+struct AgentEvent
+{
+  double time = 0.0;
+  std::string vname;
+  double x = 0.0;
+  double y = 0.0;
+  bool created = false;
+  bool in_area = false;
 };
 
 class MissionMonitor : public AppCastingMOOSApp
@@ -50,19 +74,29 @@ private: // Configuration variables
   bool debug;
   std::string termination_condition;
   double evaluation_area_offset;
+  unsigned int debug_log_size;
+  double agent_timeout; // Seconds without a report before an agent is stale
   void updateAgents(CMOOSMsg &msg);
   void updateMissionArea(CMOOSMsg &msg);
+  void markStaleAgents();
+  void checkTermination();
 
 private: // State variables
   double m_nav_x = 0.0;
   double m_nav_y = 0.0;
   double m_nav_hdg = 0.0;
   std::string m_agent_id;
-  std::string m_debug_messages; // Accumulate debug messages
+  RingBuffer<AgentEvent> m_debug_events; // Most recent agent updates
 
   std::unordered_map<std::string, Agent> m_agent_map;
+  unsigned int m_num_out; // Agents that are out of bounds or stale
+  bool m_mission_evaluated;
+
+  // Names of non-stale agents, least recently reported first
+  std::list<std::string> m_report_order;
   XYPolygon m_original_poly;
   XYPolygon m_offset_poly;
+  PolygonGrid m_region_grid; // Fast inside-or-within-offset lookup
 };
 
 #endif
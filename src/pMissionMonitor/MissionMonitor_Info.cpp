@@ -73,6 +73,11 @@ void showExampleConfigAndExit() {
   blk("  AppTick   = 4                                                 ");
   blk("  CommsTick = 4                                                 ");
   blk("                                                                ");
+  blk("  debug                  = false                                ");
+  blk("  debug_log_size         = 100                                  ");
+  blk("  termination_condition  = all_out_of_bounds  // or any_...     ");
+  blk("  evaluation_area_offset = 10                                   ");
+  blk("  agent_timeout          = 10   // secs, 0 disables             ");
   blk("}                                                               ");
   blk("                                                                ");
   exit(0);
@@ -6,18 +6,51 @@
 /************************************************************/
 
 #include <iterator>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <cstring>
+#include <string_view>
 #include "MBUtils.h"
 #include "ACTable.h"
 #include "SectorSense.h"
+#include "swim_file.h"
 #include "XYPolygon.h" // Add this include for polygon support
 
 using namespace std;
 
+// Swim files round positions to 0.1 m, so an alert for a preloaded id
+// further than this from the file's position is a different swimmer
+static const double PRELOAD_POS_TOLERANCE = 1.0;
+
 //---------------------------------------------------------
 // Constructor()
 
 SectorSense::SectorSense()
 {
+  m_lockstep = false;
+  m_lockstep_tick_var     = "LOCKSTEP_TICK";
+  m_lockstep_decision_var = "LOCKSTEP_DECISION";
+
+  m_swim_file_first_id = 1;
+  m_swimmers_preloaded = 0;
+  m_preload_mismatches = 0;
+
+  m_vehicle_table.setStaleTime(10);
+  m_bad_vehicle_reports = 0;
+
+  m_alerts_last_batch = 0;
+  m_alerts_last_new = 0;
+  m_alerts_max_batch = 0;
+  m_alerts_total = 0;
+  m_bad_alerts = 0;
+
+  m_lockstep_step = 0;
+  m_lockstep_tick_pending = false;
+  m_lockstep_awaiting_decision = false;
+  m_lockstep_tick_time = 0;
+  m_lockstep_steps_acked = 0;
 }
 
 //---------------------------------------------------------
@@ -64,13 +97,34 @@ bool SectorSense::OnNewMail(MOOSMSG_LIST &NewMail)
         processVehicleReport(msg);
       }
       m_node_report = msg.GetString();
+    } else if (m_lockstep && key == m_lockstep_tick_var) {
+      processLockstepTick(msg);
+    } else if (m_lockstep && key == m_lockstep_decision_var) {
+      processLockstepDecision(msg);
     }
 
-
     else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
        reportRunWarning("Unhandled Mail: " + key);
    }
 
+   ingestSwimmerAlerts();
+
+   // In lockstep mode mail is comms driven (see OnStartUp), so the tick
+   // is serviced as soon as it arrives, after the rest of this batch has
+   // been applied. uSimLockstep posts the step's NAV_* before echoing
+   // the tick, so they are in this batch or an earlier one. The sense
+   // time goes out before the readings and the step after them, so a
+   // controller that has seen a reading has seen its time, and one that
+   // has seen the step has seen its readings.
+   if (m_lockstep_tick_pending) {
+     m_lockstep_tick_pending = false;
+     double now = (m_lockstep_tick_time > 0) ? m_lockstep_tick_time : MOOSTime();
+     Notify("SECTOR_SENSOR_TIME", now);
+     senseAndPublish(now);
+     Notify("SECTOR_SENSOR_STEP", m_lockstep_step);
+     m_lockstep_awaiting_decision = true;
+   }
+
    return(true);
 }
 
@@ -85,27 +139,18 @@ bool SectorSense::OnConnectToServer()
 
 void SectorSense::updateSwimmers() {
   m_swimmers_sense.clear();
-  for (const std::pair<int, Swimmer>& entry : m_swimmer_map) {
-    int id = entry.first;
-    const Swimmer& s = entry.second;
-    if (!s.rescued) {
-      m_swimmers_sense.push_back(s.position);
-    }
-  }
+  m_swimmer_store.forEachActive([this](uint32_t id, double x, double y) {
+    m_swimmers_sense.push_back(XYPoint(x, y));
+  });
 }
 
-void SectorSense::updateVehicles() {
+void SectorSense::updateVehicles(double now) {
   m_vehicles_sense.clear();
   if (!m_sense_vehicles) return;
 
-  std::vector<std::string> vnames = m_contact_ledger.getVNames();
-  for (const std::string& vname : vnames) {
-    if (m_contact_ledger.hasVNameValid(vname)) {
-      double vx = m_contact_ledger.getX(vname);
-      double vy = m_contact_ledger.getY(vname);
-      m_vehicles_sense.push_back(XYPoint(vx, vy));
-    }
-  }
+  m_vehicle_table.forEachCurrent(now, [this](uint32_t ix, double x, double y) {
+    m_vehicles_sense.push_back(XYPoint(x, y));
+  });
 }
 
 //---------------------------------------------------------
@@ -116,6 +161,21 @@ bool SectorSense::Iterate()
 {
   AppCastingMOOSApp::Iterate();
 
+  // In lockstep mode sensing is driven by LOCKSTEP_TICK, not AppTick
+  if (!m_lockstep)
+    senseAndPublish(MOOSTime());
+
+  AppCastingMOOSApp::PostReport();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: senseAndPublish()
+//            compute and post one set of sector readings, as of time
+//            now for anything that ages (e.g. vehicle reports)
+
+void SectorSense::senseAndPublish(double now)
+{
   // Update which swimmers you should be sensing
   updateSwimmers();
 
@@ -130,11 +190,8 @@ bool SectorSense::Iterate()
 
   // Handle all vehicle sensing in one block
   if (m_sense_vehicles) {
-    // Update current time for contact ledger
-    m_contact_ledger.setCurrTimeUTC(MOOSTime());
-
     // Update which vehicles you should be sensing
-    updateVehicles();
+    updateVehicles(now);
 
     // Sense vehicles
     std::vector<double> vehicle_sensor_readings = m_vehicle_sensor.query(
@@ -170,9 +227,6 @@ bool SectorSense::Iterate()
       Notify("VIEW_POLYGON", spec);
     }
   }
-
-  AppCastingMOOSApp::PostReport();
-  return(true);
 }
 
 //---------------------------------------------------------
@@ -220,6 +274,36 @@ bool SectorSense::OnStartUp()
     else if(param == "sense_vehicles") {
       handled = setBooleanOnString(m_sense_vehicles, value);
     }
+    else if(param == "lockstep") {
+      handled = setBooleanOnString(m_lockstep, value);
+    }
+    else if((param == "lockstep_tick_var") && (value != "")) {
+      m_lockstep_tick_var = toupper(value);
+      handled = true;
+    }
+    else if((param == "lockstep_decision_var") && (value != "")) {
+      m_lockstep_decision_var = toupper(value);
+      handled = true;
+    }
+    else if((param == "swim_file") && (value != "")) {
+      m_swim_file = value;
+      handled = true;
+    }
+    else if(param == "swim_file_first_id") {
+      handled = setUIntOnString(m_swim_file_first_id, value);
+    }
+    else if(param == "vehicle_stale_time") {
+      double stale_time = 0;
+      handled = setNonNegDoubleOnString(stale_time, value);
+      if (handled)
+        m_vehicle_table.setStaleTime(stale_time);
+    }
+    else if(param == "vehicle_dead_reckoning") {
+      bool dead_reckon = false;
+      handled = setBooleanOnString(dead_reckon, value);
+      if (handled)
+        m_vehicle_table.setDeadReckoning(dead_reckon);
+    }
 
     if(!handled)
       reportUnhandledConfigWarning(orig);
@@ -247,10 +331,81 @@ bool SectorSense::OnStartUp()
     );
   }
 
+  if (m_swim_file != "")
+    preloadSwimFile();
+
+  // Ticks must be sensed when they arrive, not on the next AppTick
+  if (m_lockstep)
+    SetIterateMode(REGULAR_ITERATE_AND_COMMS_DRIVEN_MAIL);
+
   registerVariables();
   return(true);
 }
 
+//---------------------------------------------------------
+// Procedure: preloadSwimFile()
+//            add every registered swimmer in the swim file at once,
+//            rather than waiting for an alert per swimmer. Unregistered
+//            swimmers are never alerted, so they are left out, but they
+//            still take up an id.
+
+bool SectorSense::preloadSwimFile()
+{
+  SwimScenario scenario;
+  unsigned int bad_line = 0;
+  if (!loadSwimFile(m_swim_file, scenario, &bad_line)) {
+    if (bad_line > 0)
+      reportConfigWarning("Bad line " + uintToString(bad_line) + " in swim_file: " + m_swim_file);
+    else
+      reportConfigWarning("Unable to open swim_file: " + m_swim_file);
+    return(false);
+  }
+
+  unsigned int count = scenario.swimmers.size();
+  m_swimmer_store.reserve(m_swim_file_first_id + count);
+  m_swimmers_sense.reserve(m_swimmers_sense.size() + count);
+  m_preload_unconfirmed.assign(count, false);
+  for (unsigned int i=0; i<count; i++) {
+    const SwimmerSpec& spec = scenario.swimmers[i];
+    if (spec.type == "unreg")
+      continue;
+    if (m_swimmer_store.add(m_swim_file_first_id + i, spec.x, spec.y)) {
+      m_swimmers_sense.push_back(XYPoint(spec.x, spec.y));
+      m_swimmers_preloaded++;
+      m_preload_unconfirmed[i] = true;
+    }
+  }
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: checkPreloadedId()
+//            the first alert for a preloaded id should put the swimmer
+//            where the swim file did. If not, the ids were guessed
+//            wrong and FOUND_SWIMMER will mark the wrong swimmers.
+
+void SectorSense::checkPreloadedId(uint32_t id, double x, double y)
+{
+  if ((id < m_swim_file_first_id) || (id - m_swim_file_first_id >= m_preload_unconfirmed.size()))
+    return;
+  std::vector<bool>::reference unconfirmed = m_preload_unconfirmed[id - m_swim_file_first_id];
+  if (!unconfirmed)
+    return;
+  unconfirmed = false;
+
+  double dx = x - m_swimmer_store.x(id);
+  double dy = y - m_swimmer_store.y(id);
+  if (hypot(dx, dy) > PRELOAD_POS_TOLERANCE) {
+    m_preload_mismatches++;
+    reportRunWarning("SWIMMER_ALERT id=" + uintToString(id) + " at (" +
+                     doubleToStringX(x, 1) + "," + doubleToStringX(y, 1) +
+                     ") is not the preloaded swimmer at (" +
+                     doubleToStringX(m_swimmer_store.x(id), 1) + "," +
+                     doubleToStringX(m_swimmer_store.y(id), 1) +
+                     "), check swim_file_first_id");
+  }
+}
+
 //---------------------------------------------------------
 // Procedure: registerVariables()
 
@@ -267,6 +422,11 @@ void SectorSense::registerVariables()
   if (m_sense_vehicles) {
     Register("NODE_REPORT", 0);
   }
+
+  if (m_lockstep) {
+    Register(m_lockstep_tick_var, 0);
+    Register(m_lockstep_decision_var, 0);
+  }
 }
 
 
@@ -315,20 +475,47 @@ bool SectorSense::buildReport()
   m_msgs << "m_swimmer_readings_str: " << m_swimmer_readings_str << endl;
   if (m_sense_vehicles) {
     m_msgs << "m_vehicle_readings_str: " << m_vehicle_readings_str << endl;
-    m_msgs << "num vehicles_tracked: " << m_contact_ledger.size() << std::endl;
+    m_msgs << "num vehicles_tracked: " << m_vehicle_table.size()
+           << " (current: " << m_vehicle_table.numCurrent(MOOSTime())
+           << ", dead reckoning: " << boolToString(m_vehicle_table.deadReckoning())
+           << ")" << std::endl;
+    if (m_bad_vehicle_reports > 0)
+      m_msgs << "bad vehicle reports: " << m_bad_vehicle_reports << std::endl;
+  }
+  m_msgs << "num swimmers_logged: " << m_swimmer_store.size()
+         << " (rescued: " << m_swimmer_store.numRescued() << ")" << std::endl;
+  m_msgs << "swimmer alerts: " << m_alerts_last_batch << " in last batch ("
+         << m_alerts_last_new << " new), max batch " << m_alerts_max_batch
+         << ", total " << m_alerts_total;
+  if (m_bad_alerts > 0)
+    m_msgs << ", bad " << m_bad_alerts;
+  m_msgs << std::endl;
+  if (m_swim_file != "") {
+    m_msgs << "num swimmers_preloaded: " << m_swimmers_preloaded
+           << " (" << m_swim_file << ")" << std::endl;
+    if (m_preload_mismatches > 0)
+      m_msgs << "preloaded ids not matching alerts: " << m_preload_mismatches << std::endl;
   }
-  m_msgs << "num swimmers_logged: " << m_swimmer_map.size() << std::endl;
   m_msgs << "latest node report: " << m_node_report << std::endl;
+  if (m_lockstep) {
+    m_msgs << "lockstep step: " << m_lockstep_step
+           << (m_lockstep_awaiting_decision ? " (awaiting " + m_lockstep_decision_var + ")" : "")
+           << std::endl;
+    m_msgs << "lockstep steps acked: " << m_lockstep_steps_acked << std::endl;
+  }
   m_msgs << "--------------------------------------------" << endl;
 
   ACTable actab(3);
   actab << " Swimmer Idx | Info | Rescued ";
   actab.addHeaderLines();
-  for (const std::pair<int, Swimmer>& entry : m_swimmer_map) {
-      int id = entry.first;
-      const Swimmer& s = entry.second;
-      actab << intToString(id) << s.position.get_spec() << boolToString(s.rescued);
-    }
+  for (uint32_t id=0; id<m_swimmer_store.endId(); id++) {
+    if (!m_swimmer_store.has(id))
+      continue;
+    string info = "unknown position";
+    if (m_swimmer_store.hasPosition(id))
+      info = XYPoint(m_swimmer_store.x(id), m_swimmer_store.y(id)).get_spec();
+    actab << uintToString(id) << info << boolToString(m_swimmer_store.rescued(id));
+  }
 
   m_msgs << actab.getFormattedString();
 
@@ -362,26 +549,96 @@ XYPolygon SectorSense::buildSectorPolygon(double cx, double cy, double heading_d
   return poly;
 }
 
-// Helper function to process a swimmer alert message
+// Case-insensitive match of an alert field name
+static bool keyIs(std::string_view key, const char* name) {
+  size_t len = strlen(name);
+  if (key.size() != len)
+    return false;
+  for (size_t i=0; i<len; i++) {
+    if (tolower((unsigned char)key[i]) != name[i])
+      return false;
+  }
+  return true;
+}
+
+// Pull id, x and y out of a swimmer alert in a single pass, without
+// copying. Example: "type=reg,x=42,y=-31,id=07"
+
+static bool scanSwimmerAlert(std::string_view alert, uint32_t& id, double& x, double& y) {
+  bool has_id = false;
+  bool has_x = false;
+  bool has_y = false;
+  while (!alert.empty()) {
+    size_t comma = alert.find(',');
+    std::string_view part = alert.substr(0, comma);
+    alert.remove_prefix((comma == std::string_view::npos) ? alert.size() : comma + 1);
+
+    size_t eq = part.find('=');
+    if (eq == std::string_view::npos)
+      continue;
+    std::string_view key = part.substr(0, eq);
+    std::string_view val = part.substr(eq + 1);
+    while (!key.empty() && isspace((unsigned char)key.front())) key.remove_prefix(1);
+    while (!key.empty() && isspace((unsigned char)key.back()))  key.remove_suffix(1);
+
+    if (keyIs(key, "id")) {
+      while (!val.empty() && isspace((unsigned char)val.front())) val.remove_prefix(1);
+      while (!val.empty() && isspace((unsigned char)val.back()))  val.remove_suffix(1);
+      const char* end = val.data() + val.size();
+      has_id = (std::from_chars(val.data(), end, id).ptr == end) && !val.empty();
+    }
+    else if (keyIs(key, "x"))
+      has_x = parseDoubleView(val, x);
+    else if (keyIs(key, "y"))
+      has_y = parseDoubleView(val, y);
+  }
+  return(has_id && has_x && has_y);
+}
+
+// Helper function to stage a swimmer alert message until the end of
+// the mail batch
 
 void SectorSense::processSwimmerAlert(CMOOSMsg& msg) {
-  // Get the id of the swimmer so we don't double count any swimmers
-  std::vector<string> mvector = parseString(msg.GetString(), ",");
-  unsigned int vsize = mvector.size();
-  for (int i=0; i<vsize; i++) {
-    string param = tolower(biteStringX(mvector[i], '='));
-    string value = mvector[i];
-    if(param == "id") {
-      // We got the id. If we don't have this id, add it.
-      // Otherwise, don't do anything.
-      unsigned int swimmer_id = std::stoi(value);
-      if (m_swimmer_map.count(swimmer_id) == 0) {
-        XYPoint position = string2Point(msg.GetString());
-        Swimmer new_swimmer(position);
-        m_swimmer_map[swimmer_id] = new_swimmer;
-      }
+  StagedAlert alert;
+  if (!scanSwimmerAlert(msg.GetString(), alert.id, alert.x, alert.y)) {
+    m_bad_alerts++;
+    reportRunWarning("Bad SWIMMER_ALERT: " + msg.GetString());
+    return;
+  }
+  m_staged_alerts.push_back(alert);
+}
+
+// Helper function to add the staged alerts to the swimmer store. Each
+// swimmer is alerted to every vehicle, so a batch repeats ids; the
+// store keeps only the first position for an id.
+
+void SectorSense::ingestSwimmerAlerts() {
+  if (m_staged_alerts.empty())
+    return;
+
+  unsigned int batch = m_staged_alerts.size();
+  uint32_t end_id = 0;
+  for (const StagedAlert& alert : m_staged_alerts)
+    end_id = std::max(end_id, alert.id + 1);
+  m_swimmer_store.reserve(end_id);
+
+  unsigned int added = 0;
+  for (const StagedAlert& alert : m_staged_alerts) {
+    if (!m_preload_unconfirmed.empty())
+      checkPreloadedId(alert.id, alert.x, alert.y);
+    if (m_swimmer_store.add(alert.id, alert.x, alert.y)) {
+      if (!m_swimmer_store.rescued(alert.id))
+        m_swimmers_sense.push_back(XYPoint(alert.x, alert.y));
+      added++;
     }
   }
+  m_staged_alerts.clear();
+
+  m_alerts_last_batch = batch;
+  m_alerts_last_new = added;
+  m_alerts_total += batch;
+  if (batch > m_alerts_max_batch)
+    m_alerts_max_batch = batch;
 }
 
 void SectorSense::processFoundSwimmer(CMOOSMsg& msg) {
@@ -391,28 +648,82 @@ void SectorSense::processFoundSwimmer(CMOOSMsg& msg) {
   for (int i=0; i<vsize; i++) {
     string param = tolower(biteStringX(mvector[i], '='));
     if(param == "id") {
-      // We got the id. If we have this id, mark it as rescued
-      // Otherwise, add it and mark it as rescued
-      unsigned int swimmer_id = std::stoi(mvector[i]);
-      if (m_swimmer_map.count(swimmer_id) > 0) {
-        // Mark that this swimmer has been saved
-        m_swimmer_map[swimmer_id].rescued = true;
-      }
-      else {
-        m_swimmer_map[swimmer_id] = Swimmer(true);
-      }
+      // We got the id. Mark it as rescued, adding it if it is new.
+      unsigned int swimmer_id = 0;
+      if (setUIntOnString(swimmer_id, mvector[i]))
+        m_swimmer_store.setRescued(swimmer_id);
     }
   }
 }
 
+// Helper function to update the vehicle table from a node report,
+// timed by the vehicle's own TIME, or when the mail arrived without one
+// Example: NAME=abe,X=100,Y=200,SPD=1.2,HDG=45,TIME=1234,...
+
 void SectorSense::processVehicleReport(CMOOSMsg& msg) {
-  std::string whynot;
-  std::string vname = m_contact_ledger.processNodeReport(msg.GetString(), whynot);
-  if (vname.empty() && !whynot.empty()) {
-    reportRunWarning("Failed to process vehicle report: " + whynot);
+  NodeReportFields fields;
+  if (!scanNodeReport(msg.m_sVal, fields) || !fields.has_x || !fields.has_y) {
+    m_bad_vehicle_reports++;
+    reportRunWarning("Failed to process vehicle report: " + msg.GetString());
+    return;
+  }
+  double spd = fields.has_spd ? fields.spd : NAN;
+  double hdg = fields.has_hdg ? fields.hdg : NAN;
+  double time = fields.has_time ? fields.time : msg.GetTime();
+  m_vehicle_table.update(fields.name, time, fields.x, fields.y, spd, hdg);
+}
+
+// Helper function to process a lockstep tick from uLockstepClock, or
+// its echo from uSimLockstep. time is the simulated time the step is
+// sensed at.
+// Format: "step=12,time=1718052301.250,dt=0.25"
+
+void SectorSense::processLockstepTick(CMOOSMsg& msg) {
+  int step = 0;
+  double time = 0;
+  std::vector<string> mvector = parseString(msg.GetString(), ",");
+  for (unsigned int i=0; i<mvector.size(); i++) {
+    string param = tolower(biteStringX(mvector[i], '='));
+    string value = mvector[i];
+    if (param == "step")
+      setIntOnString(step, value);
+    else if (param == "time")
+      setDoubleOnString(time, value);
+  }
+
+  // Ignore repeated or stale ticks so each step is sensed only once
+  if ((step > 0) && ((unsigned int)(step) > m_lockstep_step)) {
+    m_lockstep_step = step;
+    m_lockstep_tick_time = time;
+    m_lockstep_tick_pending = true;
   }
 }
 
+// Helper function to acknowledge a lockstep step once the helm has
+// made a decision from its reading. The decision var carries the step
+// the behavior acted on, echoed from SECTOR_SENSOR_STEP, either as a
+// number or as "step=12".
+
+void SectorSense::processLockstepDecision(CMOOSMsg& msg) {
+  if (!m_lockstep_awaiting_decision)
+    return;
+
+  double step = -1;
+  if (msg.IsDouble())
+    step = msg.GetDouble();
+  else
+    setDoubleOnString(step, tokStringParse(msg.GetString(), "step", ',', '='));
+
+  // A decision made from an earlier step's reading doesn't count
+  if (step < m_lockstep_step)
+    return;
+
+  m_lockstep_awaiting_decision = false;
+  m_lockstep_steps_acked++;
+  Notify("LOCKSTEP_ACK", "vname=" + m_host_community + ",step=" +
+         uintToString(m_lockstep_step));
+}
+
 std::vector<XYPolygon> SectorSense::generatePolygons(std::vector<double> sensor_readings) {
   std::vector<XYPolygon> polygons;
   for(int i=0; i<m_num_swimmer_sectors; ++i) {
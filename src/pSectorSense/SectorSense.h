@@ -11,22 +11,13 @@
 #include "MOOS/libMOOS/Thirdparty/AppCasting/AppCastingMOOSApp.h"
 #include "XYFormatUtilsPoint.h"
 #include "XYPoint.h"
+#include "XYPolygon.h"
 #include "AngleUtils.h"      // for relAngle
 #include <cmath>
 #include "general_utils.h"
 #include "sector_sensor.h"
-#include "ContactLedger.h"
-#include <unordered_set>
-#include <unordered_map>
-
-struct Swimmer {
-  XYPoint position;
-  bool rescued;
-  Swimmer(bool res) : rescued(res) {}
-  Swimmer(const XYPoint& pos) : position(pos), rescued(false) {}
-  Swimmer(const XYPoint& pos, bool res) : position(pos), rescued(res) {}
-  Swimmer() : rescued(false) {}
-};
+#include "swimmer_store.h"
+#include "vehicle_table.h"
 
 class SectorSense : public AppCastingMOOSApp
 {
@@ -38,8 +29,11 @@ class SectorSense : public AppCastingMOOSApp
                              double sector_start_deg, double sector_end_deg,
                              double radius, int arc_points);
   void processSwimmerAlert(CMOOSMsg& msg);
+  void ingestSwimmerAlerts();
   void processFoundSwimmer(CMOOSMsg& msg);
   void processVehicleReport(CMOOSMsg& msg);
+  void processLockstepTick(CMOOSMsg& msg);
+  void processLockstepDecision(CMOOSMsg& msg);
   std::vector<XYPolygon> generatePolygons(std::vector<double> sensor_readings);
   std::vector<XYPolygon> generateVehiclePolygons(std::vector<double> sensor_readings);
 
@@ -49,7 +43,10 @@ class SectorSense : public AppCastingMOOSApp
    bool OnConnectToServer();
    bool OnStartUp();
    void updateSwimmers();
-   void updateVehicles();
+   void updateVehicles(double now);
+   void senseAndPublish(double now);
+   bool preloadSwimFile();
+   void checkPreloadedId(uint32_t id, double x, double y);
 
  protected: // Standard AppCastingMOOSApp function to overload
    bool buildReport();
@@ -70,6 +67,16 @@ class SectorSense : public AppCastingMOOSApp
    bool   m_visualize_swim_sectors;
    bool   m_visualize_vehicle_sectors;
    bool   m_sense_vehicles;
+   bool   m_lockstep;
+   std::string m_lockstep_tick_var;
+   std::string m_lockstep_decision_var;
+
+   // Optional swim file (as given to uFldRescueMgr) to load swimmers
+   // from at startup. Its swimmers are taken to have ids first_id,
+   // first_id+1, ... in file order, so later alerts for them are skipped
+   // once the first one has been checked against the file.
+   std::string  m_swim_file;
+   unsigned int m_swim_file_first_id;
 
  private: // State variables
    double m_nav_x=0.0;
@@ -78,23 +85,49 @@ class SectorSense : public AppCastingMOOSApp
 
    std::vector<double>  m_sensor_buckets;
 
-   std::vector<XYPoint> m_swimmers;
-   std::vector<bool>    m_swimmers_rescued;
    std::vector<XYPoint> m_swimmers_sense;
-   std::unordered_set<int> m_swimmers_recorded;
-   std::unordered_map<int, Swimmer> m_swimmer_map;
+   SwimmerStore m_swimmer_store;
+   unsigned int m_swimmers_preloaded;
+   // Per file index, preloaded swimmers whose id no alert has checked yet
+   std::vector<bool> m_preload_unconfirmed;
+   unsigned int m_preload_mismatches;
+
+   // SWIMMER_ALERTs are staged as they arrive and added to the swimmer
+   // map together at the end of each mail batch
+   struct StagedAlert {
+     uint32_t id;
+     double   x;
+     double   y;
+   };
+   std::vector<StagedAlert> m_staged_alerts;
+   unsigned int  m_alerts_last_batch;
+   unsigned int  m_alerts_last_new;
+   unsigned int  m_alerts_max_batch;
+   unsigned long m_alerts_total;
+   unsigned int  m_bad_alerts;
 
    std::string m_sensor_readings_str;
    std::string m_swimmer_readings_str;
    SectorSensor m_swimmer_sensor;
 
-   // Vehicle sensing components
-   ContactLedger m_contact_ledger;
+   // Vehicle sensing components. Reports older than the table's stale
+   // time are not sensed, and with dead reckoning on the rest are
+   // extrapolated to the time of the reading.
+   VehicleTable m_vehicle_table;
+   unsigned int m_bad_vehicle_reports;
    std::vector<XYPoint> m_vehicles_sense;
    SectorSensor m_vehicle_sensor;
    std::string m_vehicle_readings_str;
 
    std::string m_node_report;
+
+   // Lockstep state. A step is sensed once when its tick arrives and
+   // acknowledged once the helm echoes the step in a decision.
+   unsigned int m_lockstep_step;
+   bool   m_lockstep_tick_pending;
+   bool   m_lockstep_awaiting_decision;
+   double m_lockstep_tick_time;
+   unsigned int m_lockstep_steps_acked;
 };
 
 #endif
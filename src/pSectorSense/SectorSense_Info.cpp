@@ -74,6 +74,27 @@ void showExampleConfigAndExit()
   blk("  AppTick   = 4                                                 ");
   blk("  CommsTick = 4                                                 ");
   blk("                                                                ");
+  blk("  // Optionally load every reg swimmer at startup instead of    ");
+  blk("  // one SWIMMER_ALERT at a time. Ids are assumed to follow file");
+  blk("  // order, from swim_file_first_id (default 1). Alerts that    ");
+  blk("  // don't match the file's positions raise a run warning.      ");
+  blk("  swim_file          = mit_rand.txt                             ");
+  blk("  swim_file_first_id = 1                                        ");
+  blk("                                                                ");
+  blk("  // With sense_vehicles, vehicles not heard from in this many  ");
+  blk("  // seconds are dropped (0 keeps them). Dead reckoning moves   ");
+  blk("  // each one along its reported heading and speed up to the    ");
+  blk("  // time of the reading.                                       ");
+  blk("  vehicle_stale_time     = 10                                   ");
+  blk("  vehicle_dead_reckoning = false                                ");
+  blk("                                                                ");
+  blk("  // With lockstep, sense once per tick instead of per AppTick, ");
+  blk("  // as of the tick's time, and ack the step once the decision  ");
+  blk("  // var echoes it. With uSimLockstep, sense on its echo of the ");
+  blk("  // tick, LOCKSTEP_SIM_TICK, so the step's NAV_* are in first. ");
+  blk("  lockstep              = false                                 ");
+  blk("  lockstep_tick_var     = LOCKSTEP_TICK                         ");
+  blk("  lockstep_decision_var = LOCKSTEP_DECISION                     ");
   blk("}                                                               ");
   blk("                                                                ");
   exit(0);
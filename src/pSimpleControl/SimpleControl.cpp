@@ -6,19 +6,70 @@
 /************************************************************/
 
 #include <iterator>
+#include <cmath>
+#include <string_view>
 #include "MBUtils.h"
 #include "ACTable.h"
+#include "AngleUtils.h"
+#include "general_utils.h"
 #include "SimpleControl.h"
 
 using namespace std;
 
+typedef chrono::steady_clock Clock;
+
 //---------------------------------------------------------
 // Constructor()
 
 SimpleControl::SimpleControl()
 {
-  m_rud_gain = 0.1;
-  m_const_thrust = 20; 
+  m_swimmer_sectors = 0;
+  m_vehicle_sectors = 0;
+  m_sense_vehicles  = false;
+  m_lockstep        = false;
+
+  m_yaw_kp = 1.2;
+  m_yaw_ki = 0;
+  m_yaw_kd = 0;
+  m_yaw_integral_limit = 20;
+  m_max_rudder = 100;
+
+  m_const_thrust     = 20;
+  m_thrust_per_speed = 20;
+  m_max_thrust       = 100;
+
+  m_network_loaded  = false;
+  m_expected_size   = 0;
+  m_nav_heading     = 0;
+  m_nav_heading_set = false;
+
+  m_desired_heading = 0;
+  m_desired_speed   = 0;
+  m_desired_thrust  = 0;
+  m_desired_rudder  = 0;
+
+  m_pid_integral   = 0;
+  m_pid_prev_error = 0;
+  m_pid_prev_time  = -1;
+
+  m_lockstep_step      = 0;
+  m_lockstep_echoed    = 0;
+  m_lockstep_time      = -1;
+  m_readings_acted     = 0;
+  m_readings_at_echo   = 0;
+
+  m_tick_count        = 0;
+  m_tick_latency_sum  = 0;
+  m_tick_latency_max  = 0;
+  m_tick_compute_max  = 0;
+  m_total_count       = 0;
+  m_total_latency_sum = 0;
+  m_total_latency_max = 0;
+  m_last_tick_count        = 0;
+  m_last_tick_latency_mean = 0;
+  m_last_tick_latency_max  = 0;
+  m_last_tick_compute_max  = 0;
+  m_bad_readings = 0;
 }
 
 //---------------------------------------------------------
@@ -30,45 +81,83 @@ SimpleControl::~SimpleControl()
 
 //---------------------------------------------------------
 // Procedure: OnNewMail()
+//   Purpose: Apply the whole batch (so a NAV_HEADING that came with
+//            the reading is used), then act on the newest reading
+//            right away. Mail is comms driven (see OnStartUp), so this
+//            runs as mail arrives, not on the next AppTick. Older
+//            readings in the same batch are stale and skipped.
 
 bool SimpleControl::OnNewMail(MOOSMSG_LIST &NewMail)
 {
+  m_batch_start = Clock::now();
   AppCastingMOOSApp::OnNewMail(NewMail);
 
+  string reading;
+  double reading_time = -1;
+  bool   new_heading  = false;
+
   MOOSMSG_LIST::iterator p;
   for(p=NewMail.begin(); p!=NewMail.end(); p++) {
     CMOOSMsg &msg = *p;
     string key    = msg.GetKey();
 
-#if 0 // Keep these around just for template
-    string comm  = msg.GetCommunity();
-    double dval  = msg.GetDouble();
-    string sval  = msg.GetString(); 
-    string msrc  = msg.GetSource();
-    double mtime = msg.GetTime();
-    bool   mdbl  = msg.IsDouble();
-    bool   mstr  = msg.IsString();
-#endif
-
     if(key == "SECTOR_SENSOR_READING") {
-      std::vector<std::string> sensor_str;
-      sensor_str = parseString(msg.GetString(), ',');
-      m_sensor.clear();
-      for (int i=0; i<sensor_str.size(); i++){
-	
-	double temp_dbl;
-	if (!setDoubleOnString(temp_dbl, msg.GetString())){
-	    reportRunWarning("Unhandled Mail: " + key + " : " + msg.GetString());
-	    break; 
-	}	
-	m_sensor.push_back(temp_dbl); 
-      }
-
-    } else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
-       reportRunWarning("Unhandled Mail: " + key);
-   }
-	
-   return(true);
+      reading      = msg.GetString();
+      reading_time = msg.GetTime();
+    }
+    else if(key == "NAV_HEADING") {
+      m_nav_heading     = msg.GetDouble();
+      m_nav_heading_set = true;
+      new_heading       = true;
+    }
+    else if(m_lockstep && (key == "SECTOR_SENSOR_TIME"))
+      m_lockstep_time = msg.GetDouble();
+    else if(m_lockstep && (key == "SECTOR_SENSOR_STEP"))
+      m_lockstep_step = (unsigned int)(msg.GetDouble());
+    else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
+      reportRunWarning("Unhandled Mail: " + key);
+  }
+
+  if(!m_nav_heading_set)
+    return(true);
+
+  if(reading_time >= 0) {
+    if(!parseSensorReading(reading)) {
+      m_bad_readings++;
+      return(true);
+    }
+    computeSetpoints();
+    actuate(reading_time);
+    m_readings_acted++;
+  }
+  // Between readings, keep closing the loop on the latest heading. In
+  // lockstep mode the heading only changes with a step, whose reading
+  // follows, so the PID only runs on readings.
+  else if(new_heading && !m_lockstep && (m_pid_prev_time >= 0))
+    actuate(-1);
+
+  if(m_lockstep)
+    postLockstepDecision();
+
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: postLockstepDecision()
+//   Purpose: Echo a new SECTOR_SENSOR_STEP once a reading has been
+//            acted on since the last echo, so pSectorSense acks it.
+//            The step is posted after its reading, so the reading
+//            acted on is the step's own. DESIRED_* went out first.
+
+void SimpleControl::postLockstepDecision()
+{
+  if((m_lockstep_step <= m_lockstep_echoed) ||
+     (m_readings_acted == m_readings_at_echo))
+    return;
+
+  m_lockstep_echoed  = m_lockstep_step;
+  m_readings_at_echo = m_readings_acted;
+  Notify("LOCKSTEP_DECISION", m_lockstep_step);
 }
 
 //---------------------------------------------------------
@@ -88,44 +177,239 @@ bool SimpleControl::Iterate()
 {
   AppCastingMOOSApp::Iterate();
 
-  if (m_sensor.size() == 0){
-    AppCastingMOOSApp::PostReport();
-    return(true);
+  // Roll the per-tick latency stats over
+  m_last_tick_count        = m_tick_count;
+  m_last_tick_latency_mean = 0;
+  if(m_tick_count > 0)
+    m_last_tick_latency_mean = m_tick_latency_sum / m_tick_count;
+  m_last_tick_latency_max  = m_tick_latency_max;
+  m_last_tick_compute_max  = m_tick_compute_max;
+
+  if(m_tick_count > 0) {
+    string report = "count=" + uintToString(m_tick_count);
+    report += ",mean_ms=" + doubleToString(m_last_tick_latency_mean * 1000, 3);
+    report += ",max_ms=" + doubleToString(m_last_tick_latency_max * 1000, 3);
+    report += ",compute_max_ms=" + doubleToString(m_last_tick_compute_max * 1000, 3);
+    Notify("SIMPLE_CONTROL_LATENCY", report);
   }
 
-  int number_sectors = m_sensor.size();
-  double number_sec_dbl = static_cast<double>(number_sectors);
-
-  // Coordinates of each wieghted reading in body relative coordinates
-  std::vector<double> rel_x; // needed?
-  std::vector<double> rel_y;
-  double sum_x = 0.0;
-  double sum_y = 0.0; 
-  
-  for (int i=0; i<m_sensor.size(); i++){
-    // angle for this sensor
-    double i_dbl = static_cast<double>(i); 
-    double angle = 360.0 / number_sec_dbl * i_dbl;
-    rel_x.push_back( sin( 3.14 / 180.0 * angle) * m_sensor[i]);
-    rel_y.push_back( cos( 3.14 / 180.0 * angle) * m_sensor[i]);
-    sum_x += sin( 3.14 / 180.0 * angle) * m_sensor[i];
-    sum_y += cos( 3.14 / 180.0 * angle) * m_sensor[i]; 
-  }
-
-  // get the best angle we need to move to by computing the
-  // atan of the local weighted inputs 
-  double best_rel_angle = atan2(sum_y, sum_x);
-  double desired_rudder = m_rud_gain * best_rel_angle; // Might need a negative sign?
-
-  // Post it
-  Notify("DESIRED_RUDDER", desired_rudder);
-  Notify("DESIRED_THRUST", m_const_thrust);  
-  
-  
+  m_tick_count       = 0;
+  m_tick_latency_sum = 0;
+  m_tick_latency_max = 0;
+  m_tick_compute_max = 0;
+
   AppCastingMOOSApp::PostReport();
   return(true);
 }
 
+//---------------------------------------------------------
+// Procedure: parseSensorReading()
+//   Purpose: Parse a comma separated reading into m_sensor in place,
+//            without splitting it into strings first.
+
+bool SimpleControl::parseSensorReading(const string& str)
+{
+  m_sensor.clear();
+  string_view rest(str);
+  while(true) {
+    size_t comma = rest.find(',');
+    double val;
+    if(!parseDoubleView(rest.substr(0, comma), val)) {
+      reportRunWarning("Bad SECTOR_SENSOR_READING: " + str);
+      return(false);
+    }
+    m_sensor.push_back(val);
+    if(comma == string_view::npos)
+      break;
+    rest.remove_prefix(comma + 1);
+  }
+
+  if((m_expected_size > 0) && ((int)m_sensor.size() != m_expected_size)) {
+    reportRunWarning("SECTOR_SENSOR_READING size mismatch. Expected: " +
+                     intToString(m_expected_size) + ", received: " +
+                     uintToString((unsigned int)m_sensor.size()));
+    return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: computeSetpoints()
+//   Purpose: Turn the latest reading into a desired heading and
+//            thrust. The network's outputs are a speed and a heading
+//            relative to the current one, as in BHV_Neural_Network.
+
+void SimpleControl::computeSetpoints()
+{
+  if(m_network_loaded) {
+    vector<double> outputs = m_network.forward(m_sensor);
+    m_desired_speed   = outputs[0];
+    m_desired_heading = angle360(m_nav_heading + outputs[1]);
+    m_desired_thrust  = m_desired_speed * m_thrust_per_speed;
+    if(m_desired_thrust < 0)
+      m_desired_thrust = 0;
+    if(m_desired_thrust > m_max_thrust)
+      m_desired_thrust = m_max_thrust;
+    return;
+  }
+
+  // No network: head for the center of mass of the swimmer sectors.
+  // Any vehicle sectors follow the swimmer ones and are left out.
+  int num_sectors = m_sensor.size();
+  if((m_swimmer_sectors > 0) && (m_swimmer_sectors < num_sectors))
+    num_sectors = m_swimmer_sectors;
+
+  double sum_x = 0;
+  double sum_y = 0;
+  for(int i=0; i<num_sectors; i++) {
+    double angle = sectorToAngle(num_sectors, i) * M_PI / 180.0;
+    sum_x += sin(angle) * m_sensor[i];
+    sum_y += cos(angle) * m_sensor[i];
+  }
+
+  // Bearing of the center of mass, clockwise from the bow
+  double rel_bearing = 0;
+  if((sum_x != 0) || (sum_y != 0))
+    rel_bearing = atan2(sum_x, sum_y) * 180.0 / M_PI;
+
+  m_desired_heading = angle360(m_nav_heading + rel_bearing);
+  m_desired_speed   = 0;
+  m_desired_thrust  = m_const_thrust;
+}
+
+//---------------------------------------------------------
+// Procedure: actuate()
+//   Purpose: Run the heading PID and post the commands. reading_time
+//            is the post time of the reading being acted on, or
+//            negative when only the heading changed.
+
+void SimpleControl::actuate(double reading_time)
+{
+  // In lockstep mode the PID runs on the step's simulated time, so the
+  // result doesn't depend on how fast steps go
+  double pid_time = MOOSTime();
+  if(m_lockstep && (m_lockstep_time >= 0))
+    pid_time = m_lockstep_time;
+  double error = calcDeltaHeading(m_nav_heading, m_desired_heading);
+  m_desired_rudder = headingPID(error, pid_time);
+
+  Notify("DESIRED_RUDDER", m_desired_rudder);
+  Notify("DESIRED_THRUST", m_desired_thrust);
+
+  if(reading_time < 0)
+    return;
+
+  double latency = MOOSTime() - reading_time;
+  double compute = chrono::duration<double>(Clock::now() - m_batch_start).count();
+  if(latency < 0)
+    latency = 0;
+
+  m_tick_count++;
+  m_tick_latency_sum += latency;
+  if(latency > m_tick_latency_max)
+    m_tick_latency_max = latency;
+  if(compute > m_tick_compute_max)
+    m_tick_compute_max = compute;
+
+  m_total_count++;
+  m_total_latency_sum += latency;
+  if(latency > m_total_latency_max)
+    m_total_latency_max = latency;
+}
+
+//---------------------------------------------------------
+// Procedure: headingPID()
+//   Purpose: Rudder from the heading error (degrees, positive to
+//            starboard), with the integral term and output clamped.
+
+double SimpleControl::headingPID(double error, double time)
+{
+  double derivative = 0;
+  if(m_pid_prev_time >= 0) {
+    double dt = time - m_pid_prev_time;
+    if(dt > 0) {
+      m_pid_integral += error * dt;
+      derivative = (error - m_pid_prev_error) / dt;
+    }
+  }
+  m_pid_prev_error = error;
+  m_pid_prev_time  = time;
+
+  if(m_pid_integral > m_yaw_integral_limit)
+    m_pid_integral = m_yaw_integral_limit;
+  if(m_pid_integral < -m_yaw_integral_limit)
+    m_pid_integral = -m_yaw_integral_limit;
+
+  double rudder = m_yaw_kp * error + m_yaw_ki * m_pid_integral + m_yaw_kd * derivative;
+  if(rudder > m_max_rudder)
+    rudder = m_max_rudder;
+  if(rudder < -m_max_rudder)
+    rudder = -m_max_rudder;
+  return(rudder);
+}
+
+//---------------------------------------------------------
+// Procedure: loadNetwork()
+//   Purpose: Read the weights, structure and output bounds from lines
+//            0-2 of the network file, the format BHV_Neural_Network
+//            reads.
+
+bool SimpleControl::loadNetwork()
+{
+  vector<string> lines = fileBuffer(m_network_file);
+  if(lines.size() < 3) {
+    reportConfigWarning("Network file not found, or too short: " + m_network_file);
+    return(false);
+  }
+
+  vector<double> weights;
+  string warning;
+  if(!setVecDoubleOnString(weights, lines[0], warning)) {
+    reportConfigWarning("Bad network weights on line 0 of " + m_network_file + ". " + warning);
+    return(false);
+  }
+
+  vector<int> structure;
+  warning = "";
+  if(!setVecIntOnString(structure, lines[1], warning) || (structure.size() == 0)) {
+    reportConfigWarning("Bad network structure on line 1 of " + m_network_file + ". " + warning);
+    return(false);
+  }
+
+  if(structure.back() < 2) {
+    reportConfigWarning("Network needs speed and heading outputs, has " +
+                        intToString(structure.back()));
+    return(false);
+  }
+
+  if(structure[0] != m_expected_size) {
+    reportConfigWarning("Network input size mismatch. Network expects " +
+                        intToString(structure[0]) + " inputs, but sensor configuration expects " +
+                        intToString(m_expected_size) + " (swimmer_sectors=" +
+                        intToString(m_swimmer_sectors) + ", vehicle_sectors=" +
+                        intToString(m_vehicle_sectors) + ", sense_vehicles=" +
+                        boolToString(m_sense_vehicles) + ")");
+    return(false);
+  }
+
+  vector<double> bounds_flat;
+  warning = "";
+  if(!setVecDoubleOnString(bounds_flat, lines[2], warning) ||
+     (bounds_flat.size() != 2 * (size_t)structure.back())) {
+    reportConfigWarning("Bad network bounds on line 2 of " + m_network_file + ". " + warning);
+    return(false);
+  }
+  vector<vector<double>> bounds = reshapeVector2D(bounds_flat, structure.back(), 2);
+
+  string err;
+  m_network.setVerbose(false);
+  if(!m_network.initialize(weights, structure, bounds, err)) {
+    reportConfigWarning("Neural network failed to initialize. " + err);
+    return(false);
+  }
+  return(true);
+}
+
 //---------------------------------------------------------
 // Procedure: OnStartUp()
 //            happens before connection is open
@@ -134,6 +418,10 @@ bool SimpleControl::OnStartUp()
 {
   AppCastingMOOSApp::OnStartUp();
 
+  // By default OnNewMail only runs once per AppTick. Have it run as
+  // soon as mail arrives so readings are acted on without waiting.
+  SetIterateMode(REGULAR_ITERATE_AND_COMMS_DRIVEN_MAIL);
+
   STRING_LIST sParams;
   m_MissionReader.EnableVerbatimQuoting(false);
   if(!m_MissionReader.GetConfiguration(GetAppName(), sParams))
@@ -147,19 +435,62 @@ bool SimpleControl::OnStartUp()
     string value = line;
 
     bool handled = false;
-    if(param == "rudder_gain") {
-      handled = setPosDoubleOnString(m_rud_gain, value);
+    if(param == "network_file") {
+      m_network_file = value;
+      handled = (value != "");
+    }
+    else if(param == "swimmer_sectors") {
+      handled = setIntOnString(m_swimmer_sectors, value);
+    }
+    else if(param == "vehicle_sectors") {
+      handled = setIntOnString(m_vehicle_sectors, value);
+    }
+    else if(param == "sense_vehicles") {
+      handled = setBooleanOnString(m_sense_vehicles, value);
+    }
+    else if((param == "yaw_pid_kp") || (param == "rudder_gain")) {
+      handled = setNonNegDoubleOnString(m_yaw_kp, value);
+    }
+    else if(param == "yaw_pid_ki") {
+      handled = setNonNegDoubleOnString(m_yaw_ki, value);
+    }
+    else if(param == "yaw_pid_kd") {
+      handled = setNonNegDoubleOnString(m_yaw_kd, value);
+    }
+    else if(param == "yaw_pid_integral_limit") {
+      handled = setNonNegDoubleOnString(m_yaw_integral_limit, value);
+    }
+    else if(param == "max_rudder") {
+      handled = setPosDoubleOnString(m_max_rudder, value);
     }
     else if(param == "constant_thrust") {
       handled = setPosDoubleOnString(m_const_thrust, value);
     }
+    else if(param == "thrust_per_speed") {
+      handled = setPosDoubleOnString(m_thrust_per_speed, value);
+    }
+    else if(param == "max_thrust") {
+      handled = setPosDoubleOnString(m_max_thrust, value);
+    }
+    else if(param == "lockstep") {
+      handled = setBooleanOnString(m_lockstep, value);
+    }
 
     if(!handled)
       reportUnhandledConfigWarning(orig);
 
   }
-  
-  registerVariables();	
+
+  // Readings are the swimmer sectors, then the vehicle sectors if
+  // vehicles are sensed
+  m_expected_size = m_swimmer_sectors;
+  if(m_sense_vehicles)
+    m_expected_size += m_vehicle_sectors;
+
+  if(m_network_file != "")
+    m_network_loaded = loadNetwork();
+
+  registerVariables();
   return(true);
 }
 
@@ -170,27 +501,57 @@ void SimpleControl::registerVariables()
 {
   AppCastingMOOSApp::RegisterVariables();
   Register("SECTOR_SENSOR_READING", 0);
+  Register("NAV_HEADING", 0);
+  if(m_lockstep) {
+    Register("SECTOR_SENSOR_TIME", 0);
+    Register("SECTOR_SENSOR_STEP", 0);
+  }
 }
 
 
 //------------------------------------------------------------
 // Procedure: buildReport()
 
-bool SimpleControl::buildReport() 
+bool SimpleControl::buildReport()
 {
-  m_msgs << "============================================" << endl;
-  m_msgs << "File:                                       " << endl;
-  m_msgs << "============================================" << endl;
-
-  ACTable actab(4);
-  actab << "Alpha | Bravo | Charlie | Delta";
+  string policy = "center of mass";
+  if(m_network_loaded)
+    policy = "network (" + m_network_file + ")";
+  else if(m_network_file != "")
+    policy = "center of mass (network failed to load)";
+
+  m_msgs << "Policy: " << policy << endl;
+  m_msgs << "Expected reading size: " << m_expected_size << endl;
+  m_msgs << "Bad readings: " << m_bad_readings << endl;
+  if(m_lockstep)
+    m_msgs << "Lockstep: step " << m_lockstep_step << ", acked "
+           << m_lockstep_echoed << endl;
+  m_msgs << endl;
+
+  ACTable actab(5);
+  actab << "Nav Hdg | Desired Hdg | Desired Spd | Rudder | Thrust";
   actab.addHeaderLines();
-  actab << "one" << "two" << "three" << "four";
-  m_msgs << actab.getFormattedString();
+  actab << doubleToString(m_nav_heading, 1) << doubleToString(m_desired_heading, 1)
+        << doubleToString(m_desired_speed, 2) << doubleToString(m_desired_rudder, 1)
+        << doubleToString(m_desired_thrust, 1);
+  m_msgs << actab.getFormattedString() << endl << endl;
+
+  double total_mean = 0;
+  if(m_total_count > 0)
+    total_mean = m_total_latency_sum / m_total_count;
+
+  m_msgs << "Sense-to-actuate latency (ms)" << endl;
+  ACTable lattab(5);
+  lattab << "Window | Readings | Mean | Max | Compute Max";
+  lattab.addHeaderLines();
+  lattab << "last tick" << uintToString(m_last_tick_count)
+         << doubleToString(m_last_tick_latency_mean * 1000, 3)
+         << doubleToString(m_last_tick_latency_max * 1000, 3)
+         << doubleToString(m_last_tick_compute_max * 1000, 3);
+  lattab << "total" << uintToString(m_total_count)
+         << doubleToString(total_mean * 1000, 3)
+         << doubleToString(m_total_latency_max * 1000, 3) << "-";
+  m_msgs << lattab.getFormattedString();
 
   return(true);
 }
-
-
-
-
@@ -8,32 +8,104 @@
 #ifndef SimpleControl_HEADER
 #define SimpleControl_HEADER
 
+#include <string>
+#include <vector>
+#include <chrono>
 #include "MOOS/libMOOS/Thirdparty/AppCasting/AppCastingMOOSApp.h"
+#include "network.h"
 
+// Drives DESIRED_RUDDER/DESIRED_THRUST straight from the sector
+// sensor, with no helm in the loop. Each SECTOR_SENSOR_READING is run
+// through the policy network (the same file BHV_Neural_Network loads)
+// as soon as it arrives, and the resulting heading is tracked with a
+// PID on heading error. Without a network, the swimmer sectors' center
+// of mass is steered toward at a constant thrust.
 class SimpleControl : public AppCastingMOOSApp
 {
  public:
    SimpleControl();
    ~SimpleControl();
 
- protected: // Standard MOOSApp functions to overload  
+ protected: // Standard MOOSApp functions to overload
    bool OnNewMail(MOOSMSG_LIST &NewMail);
    bool Iterate();
    bool OnConnectToServer();
    bool OnStartUp();
 
- protected: // Standard AppCastingMOOSApp function to overload 
+ protected: // Standard AppCastingMOOSApp function to overload
    bool buildReport();
 
  protected:
    void registerVariables();
+   bool loadNetwork();
+   bool parseSensorReading(const std::string& str);
+   void computeSetpoints();
+   void actuate(double reading_time);
+   double headingPID(double error, double time);
+   void   postLockstepDecision();
 
  private: // Configuration variables
-   double m_rud_gain;
-   double m_const_thrust; 
+   std::string m_network_file;
+   int    m_swimmer_sectors;
+   int    m_vehicle_sectors;
+   bool   m_sense_vehicles;
+   bool   m_lockstep;
+
+   double m_yaw_kp;
+   double m_yaw_ki;
+   double m_yaw_kd;
+   double m_yaw_integral_limit;
+   double m_max_rudder;
+
+   double m_const_thrust;
+   double m_thrust_per_speed;
+   double m_max_thrust;
 
  private: // State variables
-   std::vector<double> m_sensor; 
+   NeuralNetwork m_network;
+   bool   m_network_loaded;
+   int    m_expected_size;
+
+   std::vector<double> m_sensor;
+   double m_nav_heading;
+   bool   m_nav_heading_set;
+
+   // Setpoints from the latest reading
+   double m_desired_heading;
+   double m_desired_speed;
+   double m_desired_thrust;
+   double m_desired_rudder;
+
+   // Heading PID memory
+   double m_pid_integral;
+   double m_pid_prev_error;
+   double m_pid_prev_time;
+
+   // Lockstep: the latest step and sense time from pSectorSense, the
+   // last step echoed in LOCKSTEP_DECISION, and readings acted on in
+   // total and as of that echo
+   unsigned int  m_lockstep_step;
+   unsigned int  m_lockstep_echoed;
+   double        m_lockstep_time;
+   unsigned long m_readings_acted;
+   unsigned long m_readings_at_echo;
+
+   // Sense-to-actuate latency, from the reading's post time to our
+   // DESIRED_RUDDER post, and the part of it spent in this app. Kept
+   // per tick and since startup.
+   std::chrono::steady_clock::time_point m_batch_start;
+   unsigned int  m_tick_count;
+   double        m_tick_latency_sum;
+   double        m_tick_latency_max;
+   double        m_tick_compute_max;
+   unsigned long m_total_count;
+   double        m_total_latency_sum;
+   double        m_total_latency_max;
+   unsigned int  m_last_tick_count;
+   double        m_last_tick_latency_mean;
+   double        m_last_tick_latency_max;
+   double        m_last_tick_compute_max;
+   unsigned int  m_bad_readings;
 };
 
-#endif 
+#endif
@@ -20,11 +20,18 @@ void showSynopsis()
 {
   blk("SYNOPSIS:                                                       ");
   blk("------------------------------------                            ");
-  blk("  The pSimpleControl application is used for               ");
-  blk("                                                                ");
-  blk("                                                                ");
-  blk("                                                                ");
-  blk("                                                                ");
+  blk("  The pSimpleControl application drives DESIRED_RUDDER and      ");
+  blk("  DESIRED_THRUST straight from SECTOR_SENSOR_READING, with no   ");
+  blk("  helm in the loop. Each reading is run through the policy      ");
+  blk("  network (the file BHV_Neural_Network loads) as soon as it     ");
+  blk("  arrives, and the network's heading is tracked with a PID on   ");
+  blk("  heading error. Without a network it steers toward the center  ");
+  blk("  of mass of the swimmer sectors at a constant thrust. The app  ");
+  blk("  runs in REGULAR_ITERATE_AND_COMMS_DRIVEN_MAIL mode, so mail   ");
+  blk("  is handled when it arrives rather than once per AppTick.      ");
+  blk("  With lockstep = true it echoes each pSectorSense step it has  ");
+  blk("  acted on as LOCKSTEP_DECISION and runs its PID on simulated   ");
+  blk("  time, for use with pSectorSense lockstep.                     ");
 }
 
 //----------------------------------------------------------------
@@ -72,8 +79,23 @@ void showExampleConfigAndExit()
   blk("ProcessConfig = pSimpleControl                              ");
   blk("{                                                               ");
   blk("  AppTick   = 4                                                 ");
-  blk("  CommsTick = 4                                                 ");
-  blk("                                                                ");
+  blk("  CommsTick = 20                                                ");
+  blk("                                                                ");
+  blk("  network_file    = neural_network_config.csv  // Default: none ");
+  blk("  swimmer_sectors = 16                                          ");
+  blk("  vehicle_sectors = 8                                           ");
+  blk("  sense_vehicles  = false                                       ");
+  blk("  lockstep        = false // Ack pSectorSense lockstep steps    ");
+  blk("                                                                ");
+  blk("  yaw_pid_kp      = 1.2   // rudder_gain is the same thing      ");
+  blk("  yaw_pid_ki      = 0                                           ");
+  blk("  yaw_pid_kd      = 0                                           ");
+  blk("  yaw_pid_integral_limit = 20                                   ");
+  blk("  max_rudder      = 100                                         ");
+  blk("                                                                ");
+  blk("  thrust_per_speed = 20   // Thrust % per m/s of network speed  ");
+  blk("  max_thrust       = 100                                        ");
+  blk("  constant_thrust  = 20   // Thrust when there is no network    ");
   blk("}                                                               ");
   blk("                                                                ");
   exit(0);
@@ -94,12 +116,23 @@ void showInterfaceAndExit()
   blk("                                                                ");
   blk("SUBSCRIPTIONS:                                                  ");
   blk("------------------------------------                            ");
-  blk("  NODE_MESSAGE = src_node=alpha,dest_node=bravo,var_name=FOO,   ");
-  blk("                 string_val=BAR                                 ");
+  blk("  SECTOR_SENSOR_READING = 0.1,0,0.8,...                         ");
+  blk("  NAV_HEADING           = 87.5                                  ");
+  blk("  SECTOR_SENSOR_STEP    = 12      (lockstep only)               ");
+  blk("  SECTOR_SENSOR_TIME    = 3.0     (lockstep only)               ");
   blk("                                                                ");
   blk("PUBLICATIONS:                                                   ");
   blk("------------------------------------                            ");
-  blk("  Publications are determined by the node message content.      ");
+  blk("  DESIRED_RUDDER = 12.4                                         ");
+  blk("  DESIRED_THRUST = 30                                           ");
+  blk("  SIMPLE_CONTROL_LATENCY = count=5,mean_ms=3.120,max_ms=6.005,  ");
+  blk("                           compute_max_ms=0.041                 ");
+  blk("    Posted each AppTick that acted on a reading. Latency runs   ");
+  blk("    from the reading's post time to DESIRED_RUDDER; compute is  ");
+  blk("    the part of it spent in this app.                           ");
+  blk("  LOCKSTEP_DECISION = 12                                        ");
+  blk("    Lockstep only. The step whose reading was acted on, posted  ");
+  blk("    after DESIRED_RUDDER and DESIRED_THRUST.                    ");
   blk("                                                                ");
   exit(0);
 }
@@ -0,0 +1,113 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LatencyHistogram.cpp                            */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#include <cmath>
+#include <sstream>
+#include "LatencyHistogram.h"
+
+using namespace std;
+
+static const double MIN_LATENCY  = 1e-6;
+static const double MAX_LATENCY  = 100;
+static const double BUCKET_RATIO = 1.05;
+
+// Bucket 0 holds everything under MIN_LATENCY, the last one everything
+// over MAX_LATENCY
+static const unsigned int NUM_BUCKETS =
+  2 + (unsigned int)ceil(log(MAX_LATENCY / MIN_LATENCY) / log(BUCKET_RATIO));
+
+//---------------------------------------------------------
+// Constructor
+
+LatencyHistogram::LatencyHistogram()
+{
+  m_buckets.resize(NUM_BUCKETS, 0);
+  clear();
+}
+
+//---------------------------------------------------------
+// Procedure: add()
+
+void LatencyHistogram::add(double latency)
+{
+  unsigned int index = 0;
+  if(latency >= MAX_LATENCY)
+    index = NUM_BUCKETS - 1;
+  else if(latency >= MIN_LATENCY)
+    index = 1 + (unsigned int)(log(latency / MIN_LATENCY) / log(BUCKET_RATIO));
+  if(index >= NUM_BUCKETS)
+    index = NUM_BUCKETS - 1;
+
+  m_buckets[index]++;
+  if((m_count == 0) || (latency < m_min))
+    m_min = latency;
+  if((m_count == 0) || (latency > m_max))
+    m_max = latency;
+  m_sum += latency;
+  m_count++;
+}
+
+//---------------------------------------------------------
+// Procedure: clear()
+
+void LatencyHistogram::clear()
+{
+  for(unsigned int i=0; i<m_buckets.size(); i++)
+    m_buckets[i] = 0;
+  m_count = 0;
+  m_min   = 0;
+  m_max   = 0;
+  m_sum   = 0;
+}
+
+//---------------------------------------------------------
+// Procedure: percentile()
+//   Purpose: Walk the buckets to the one holding the p'th sample and
+//            report its geometric midpoint, clamped to the exact
+//            min and max.
+
+double LatencyHistogram::percentile(double p) const
+{
+  if(m_count == 0)
+    return(0);
+
+  double target = p * m_count;
+  unsigned long seen = 0;
+  for(unsigned int i=0; i<m_buckets.size(); i++) {
+    seen += m_buckets[i];
+    if((seen > 0) && (seen >= target)) {
+      double value = m_min;
+      if((i > 0) && (i < m_buckets.size() - 1))
+        value = MIN_LATENCY * pow(BUCKET_RATIO, i - 0.5);
+      else if(i == m_buckets.size() - 1)
+        value = m_max;
+      if(value < m_min)
+        value = m_min;
+      if(value > m_max)
+        value = m_max;
+      return(value);
+    }
+  }
+  return(m_max);
+}
+
+//---------------------------------------------------------
+// Procedure: getJSON()
+
+string LatencyHistogram::getJSON() const
+{
+  stringstream ss;
+  ss << "{\"count\": " << m_count
+     << ", \"min_ms\": "  << min() * 1000
+     << ", \"mean_ms\": " << mean() * 1000
+     << ", \"p50_ms\": "  << percentile(0.5) * 1000
+     << ", \"p90_ms\": "  << percentile(0.9) * 1000
+     << ", \"p99_ms\": "  << percentile(0.99) * 1000
+     << ", \"p999_ms\": " << percentile(0.999) * 1000
+     << ", \"max_ms\": "  << max() * 1000 << "}";
+  return(ss.str());
+}
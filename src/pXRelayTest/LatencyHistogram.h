@@ -0,0 +1,47 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LatencyHistogram.h                              */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#ifndef LATENCY_HISTOGRAM_HEADER
+#define LATENCY_HISTOGRAM_HEADER
+
+#include <vector>
+#include <string>
+
+// Histogram of latencies in seconds. Buckets grow geometrically by 5%
+// from 1 microsecond to 100 seconds, so percentiles are within a few
+// percent at any scale with a fixed, small amount of memory. Min, max
+// and mean are kept exactly.
+class LatencyHistogram
+{
+ public:
+  LatencyHistogram();
+
+  void   add(double latency);
+  void   clear();
+
+  unsigned long count() const {return(m_count);}
+  double min() const  {return(m_count ? m_min : 0);}
+  double max() const  {return(m_count ? m_max : 0);}
+  double mean() const {return(m_count ? m_sum / m_count : 0);}
+
+  // Latency below which fraction p (0 to 1) of the samples fall
+  double percentile(double p) const;
+
+  // JSON object with count, min, mean, p50, p90, p99, p999 and max, in
+  // milliseconds
+  std::string getJSON() const;
+
+ protected:
+  std::vector<unsigned long> m_buckets;
+
+  unsigned long m_count;
+  double        m_min;
+  double        m_max;
+  double        m_sum;
+};
+
+#endif
@@ -0,0 +1,288 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LoadGenerator.cpp                               */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include "LoadGenerator.h"
+#include "MBUtils.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+// A message sent more than this long after its due time counts as late
+static const double LATE_THRESHOLD = 0.001;
+
+// Synthetic vehicles circle the origin on tracks this far apart
+static const double TRACK_SPACING = 10;
+
+static const char* STREAM_NAMES[] = {"node_report", "sensor_reading", "view_polygon", "swimmer_alert"};
+
+//---------------------------------------------------------
+// Constructor
+
+LoadGenerator::LoadGenerator()
+{
+  const char*  vars[]   = {"NODE_REPORT", "SECTOR_SENSOR_READING", "VIEW_POLYGON", "SWIMMER_ALERT"};
+  const double rates[]  = {4, 4, 1, 0.2};
+  const unsigned int bursts[] = {1, 1, 8, 1};
+
+  for(unsigned int i=0; i<NUM_STREAMS; i++) {
+    m_streams[i].name        = STREAM_NAMES[i];
+    m_streams[i].var         = vars[i];
+    m_streams[i].rate        = rates[i];
+    m_streams[i].burst       = bursts[i];
+    m_streams[i].size        = 0;
+    m_streams[i].per_vehicle = (i != SWIMMER_ALERT);
+    m_streams[i].sent        = 0;
+    m_streams[i].bytes       = 0;
+  }
+
+  m_num_vehicles   = 0;
+  m_running        = false;
+  m_stop_requested = false;
+  m_max_lag_us     = 0;
+  m_late           = 0;
+}
+
+//---------------------------------------------------------
+// Procedure: setStream()
+
+bool LoadGenerator::setStream(const string& kind, const string& spec)
+{
+  unsigned int ix = 0;
+  while((ix < NUM_STREAMS) && (kind != STREAM_NAMES[ix]))
+    ix++;
+  if(ix == NUM_STREAMS)
+    return(false);
+  Stream& stream = m_streams[ix];
+
+  vector<string> svector = parseString(spec, ',');
+  for(unsigned int i=0; i<svector.size(); i++) {
+    string param = tolower(biteStringX(svector[i], '='));
+    string value = svector[i];
+
+    bool handled = false;
+    if(param == "rate")
+      handled = setNonNegDoubleOnString(stream.rate, value);
+    else if(param == "burst")
+      handled = setUIntOnString(stream.burst, value) && (stream.burst > 0);
+    else if(param == "size")
+      handled = setUIntOnString(stream.size, value);
+    else if((param == "var") && (value != "")) {
+      stream.var = value;
+      handled = true;
+    }
+    if(!handled)
+      return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: start()
+
+void LoadGenerator::start(unsigned int num_vehicles, Publisher publisher)
+{
+  stop();
+
+  m_num_vehicles = num_vehicles;
+  m_publisher    = publisher;
+  for(unsigned int i=0; i<NUM_STREAMS; i++) {
+    m_streams[i].sent  = 0;
+    m_streams[i].bytes = 0;
+  }
+  m_max_lag_us     = 0;
+  m_late           = 0;
+  m_stop_requested = false;
+  m_start_time     = Clock::now();
+  m_running        = true;
+  m_thread = thread(&LoadGenerator::run, this);
+}
+
+//---------------------------------------------------------
+// Procedure: stop()
+
+void LoadGenerator::stop()
+{
+  if(!m_thread.joinable())
+    return;
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stop_requested = true;
+  }
+  m_stop_cv.notify_all();
+  m_thread.join();
+  m_stop_time = Clock::now();
+  m_running   = false;
+}
+
+//---------------------------------------------------------
+// Procedure: getVars()
+
+vector<string> LoadGenerator::getVars() const
+{
+  vector<string> vars;
+  for(unsigned int i=0; i<NUM_STREAMS; i++) {
+    if(m_streams[i].rate > 0)
+      vars.push_back(m_streams[i].var);
+  }
+  return(vars);
+}
+
+//---------------------------------------------------------
+// Procedure: getStats()
+
+vector<LoadGenerator::StreamStats> LoadGenerator::getStats() const
+{
+  vector<StreamStats> stats;
+  for(unsigned int i=0; i<NUM_STREAMS; i++) {
+    const Stream& stream = m_streams[i];
+    if(stream.rate <= 0)
+      continue;
+
+    StreamStats entry;
+    entry.kind  = stream.name;
+    entry.var   = stream.var;
+    entry.sent  = stream.sent;
+    entry.bytes = stream.bytes;
+    entry.requested_hz = stream.rate * stream.burst;
+    if(stream.per_vehicle)
+      entry.requested_hz *= m_num_vehicles;
+    stats.push_back(entry);
+  }
+  return(stats);
+}
+
+//---------------------------------------------------------
+// Procedure: elapsed()
+
+double LoadGenerator::elapsed() const
+{
+  Clock::time_point end = m_running ? Clock::now() : m_stop_time;
+  return(chrono::duration<double>(end - m_start_time).count());
+}
+
+//---------------------------------------------------------
+// Procedure: run()
+//   Purpose: Publish each (stream, source) pair on its own schedule.
+//            Sources of a stream are spread evenly over its period,
+//            and the next due time is the previous due time plus the
+//            period, so late sends don't push the schedule back.
+
+void LoadGenerator::run()
+{
+  struct Event {
+    double       due;
+    unsigned int kind;
+    unsigned int source;
+    bool operator>(const Event& other) const {return(due > other.due);}
+  };
+  priority_queue<Event, vector<Event>, greater<Event> > events;
+
+  for(unsigned int k=0; k<NUM_STREAMS; k++) {
+    if(m_streams[k].rate <= 0)
+      continue;
+    unsigned int sources = m_streams[k].per_vehicle ? m_num_vehicles : 1;
+    double period = 1.0 / m_streams[k].rate;
+    for(unsigned int s=0; s<sources; s++) {
+      Event event = {period * s / sources, k, s};
+      events.push(event);
+    }
+  }
+
+  unique_lock<mutex> lock(m_mutex);
+  while(!m_stop_requested && !events.empty()) {
+    Event event = events.top();
+    Clock::time_point due = m_start_time +
+      chrono::duration_cast<Clock::duration>(chrono::duration<double>(event.due));
+
+    // Sleep until the event is due, waking early only to stop
+    if(m_stop_cv.wait_until(lock, due, [this]{return(m_stop_requested);}))
+      break;
+    lock.unlock();
+
+    events.pop();
+    double t   = chrono::duration<double>(Clock::now() - m_start_time).count();
+    double lag = (t > event.due) ? (t - event.due) : 0;
+    if(lag > LATE_THRESHOLD)
+      m_late++;
+    unsigned long lag_us = (unsigned long)(lag * 1e6);
+    if(lag_us > m_max_lag_us)
+      m_max_lag_us = lag_us;
+
+    Stream& stream = m_streams[event.kind];
+    for(unsigned int b=0; b<stream.burst; b++) {
+      string msg = buildMessage(event.kind, event.source, b, t);
+      m_publisher(stream.var, msg);
+      stream.sent++;
+      stream.bytes += msg.size();
+    }
+
+    event.due += 1.0 / stream.rate;
+    events.push(event);
+    lock.lock();
+  }
+}
+
+//---------------------------------------------------------
+// Procedure: buildMessage()
+//   Purpose: Build one message in the same format the real app
+//            posts, for a vehicle circling the origin.
+
+string LoadGenerator::buildMessage(unsigned int kind, unsigned int source,
+                                   unsigned int burst_ix, double t)
+{
+  double radius = TRACK_SPACING * (1 + source % 20);
+  double angle  = 0.05 * t + source;
+  double x = radius * cos(angle);
+  double y = radius * sin(angle);
+  double hdg = fmod(360 - angle * 180 / M_PI, 360);
+  if(hdg < 0)
+    hdg += 360;
+
+  char buf[256];
+  string msg;
+  if(kind == NODE_REPORT) {
+    snprintf(buf, sizeof(buf), "NAME=v%03u,X=%.2f,Y=%.2f,SPD=1.5,HDG=%.2f,DEP=0,TYPE=kayak,"
+             "MODE=MODE@ACTIVE:SURVEYING,TIME=%.3f", source, x, y, hdg, t);
+    msg = buf;
+  }
+  else if(kind == SENSOR_READING) {
+    for(unsigned int i=0; i<16; i++) {
+      snprintf(buf, sizeof(buf), "%s%.4f", (i == 0) ? "" : ",", 0.5 + 0.5 * sin(t + i + source));
+      msg += buf;
+    }
+  }
+  else if(kind == VIEW_POLYGON) {
+    // One sector wedge of a vehicle's sensor, as pSectorSense draws them
+    unsigned int sectors = m_streams[VIEW_POLYGON].burst;
+    double a1 = 2 * M_PI * burst_ix / sectors;
+    double a2 = 2 * M_PI * (burst_ix + 1) / sectors;
+    snprintf(buf, sizeof(buf), "pts={%.1f,%.1f:%.1f,%.1f:%.1f,%.1f},label=v%03u_sector_%u,"
+             "edge_color=gray,vertex_size=0,fill_color=green,fill_transparency=0.3",
+             x, y, x + 20 * cos(a1), y + 20 * sin(a1), x + 20 * cos(a2), y + 20 * sin(a2),
+             source, burst_ix);
+    msg = buf;
+  }
+  else {
+    unsigned long id = m_streams[SWIMMER_ALERT].sent;
+    snprintf(buf, sizeof(buf), "type=reg,x=%.1f,y=%.1f,id=%lu", x, y, id);
+    msg = buf;
+  }
+
+  unsigned int size = m_streams[kind].size;
+  if(msg.size() < size) {
+    // Pad as an extra field so the messages still parse
+    msg += (kind == SENSOR_READING) ? "," : ",PAD=";
+    if(msg.size() < size)
+      msg.append(size - msg.size(), (kind == SENSOR_READING) ? '0' : 'x');
+  }
+  return(msg);
+}
@@ -0,0 +1,99 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LoadGenerator.h                                 */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#ifndef LOAD_GENERATOR_HEADER
+#define LOAD_GENERATOR_HEADER
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+// Publishes the message mix of a mission with N vehicles from its own
+// thread: NODE_REPORTs, SECTOR_SENSOR_READINGs and VIEW_POLYGON bursts
+// per vehicle, plus SWIMMER_ALERTs for the whole field. Every message
+// has a due time on a fixed schedule (vehicles are staggered across
+// each period), and the thread sleeps until the next one is due, so
+// pacing doesn't depend on the app's Iterate timing. If publishing
+// falls behind, messages are sent late rather than skipped and the lag
+// is recorded.
+class LoadGenerator
+{
+ public:
+  enum StreamKind {NODE_REPORT=0, SENSOR_READING, VIEW_POLYGON, SWIMMER_ALERT, NUM_STREAMS};
+
+  typedef std::function<void(const std::string&, const std::string&)> Publisher;
+
+  struct StreamStats {
+    std::string   kind;
+    std::string   var;
+    double        requested_hz;  // messages per second asked for
+    unsigned long sent;
+    unsigned long bytes;
+  };
+
+  LoadGenerator();
+  ~LoadGenerator() {stop();}
+
+  // kind is node_report, sensor_reading, view_polygon or swimmer_alert.
+  // spec is a comma separated list of any of rate=<hz>, burst=<msgs>,
+  // size=<bytes> (pad each message to at least this) and var=<name>.
+  // Rates are per vehicle except for swimmer_alert. A rate of 0
+  // disables the stream.
+  bool setStream(const std::string& kind, const std::string& spec);
+
+  void start(unsigned int num_vehicles, Publisher publisher);
+  void stop();
+  bool running() const {return(m_running);}
+
+  unsigned int numVehicles() const {return(m_num_vehicles);}
+  std::vector<std::string> getVars() const;
+
+  // Since the last start()
+  std::vector<StreamStats> getStats() const;
+  double        elapsed() const;
+  double        maxLag() const {return(m_max_lag_us / 1e6);}
+  unsigned long lateMessages() const {return(m_late);}
+
+ protected:
+  struct Stream {
+    std::string  name;
+    std::string  var;
+    double       rate;
+    unsigned int burst;
+    unsigned int size;
+    bool         per_vehicle;
+    std::atomic<unsigned long> sent;
+    std::atomic<unsigned long> bytes;
+  };
+
+  void        run();
+  std::string buildMessage(unsigned int kind, unsigned int source,
+                           unsigned int burst_ix, double t);
+
+ protected:
+  Stream       m_streams[NUM_STREAMS];
+  unsigned int m_num_vehicles;
+  Publisher    m_publisher;
+
+  std::thread  m_thread;
+  std::mutex   m_mutex;
+  std::condition_variable m_stop_cv;
+  std::atomic<bool> m_running;
+  bool         m_stop_requested;
+
+  std::chrono::steady_clock::time_point m_start_time;
+  std::chrono::steady_clock::time_point m_stop_time;
+  std::atomic<unsigned long> m_max_lag_us;
+  std::atomic<unsigned long> m_late;
+};
+
+#endif
@@ -21,6 +21,8 @@
 /*****************************************************************/
 
 #include <iterator>
+#include <cstdio>
+#include <fstream>
 #include "Relayer.h"
 #include "MBUtils.h"
  
@@ -38,6 +40,28 @@ Relayer::Relayer()
 
   m_start_time_postings   = 0;
   m_start_time_iterations = 0;
+
+  m_mode              = "relay";
+  m_step_duration     = 10;
+  m_drain_time        = 2;
+  m_pings_per_iterate = 1;
+  m_results_file      = "xrelay_results.json";
+  m_pong_follows      = true;
+  m_pong_app_tick     = 0;
+  m_pong_comms_tick   = 0;
+
+  m_curr_step  = 0;
+  m_sweep_done = false;
+
+  m_load_verify = false;
+}
+
+//---------------------------------------------------------
+// Destructor
+
+Relayer::~Relayer()
+{
+  m_load.stop();
 }
 
 //---------------------------------------------------------
@@ -51,7 +75,23 @@ bool Relayer::OnNewMail(MOOSMSG_LIST &NewMail)
     
     string key = msg.GetKey();
 
-    if(key == m_incoming_var) 
+    if(m_mode == "load") {
+      map<string, unsigned long>::iterator q = m_load_received.find(key);
+      if(q != m_load_received.end())
+        q->second++;
+      continue;
+    }
+    if(key != m_incoming_var)
+      continue;
+
+    // Echo pongs right away rather than waiting for Iterate
+    if(m_mode == "pong") {
+      followPingTicks(msg.GetString());
+      Notify(m_outgoing_var, msg.GetString());
+    }
+    else if(m_mode == "ping")
+      handlePong(msg.GetString());
+    else
       m_tally_recd++;
   }
   return(true);
@@ -75,6 +115,14 @@ void Relayer::RegisterVariables()
 {
   if(m_incoming_var != "")
     Register(m_incoming_var, 0);
+
+  if((m_mode == "load") && m_load_verify) {
+    vector<string> vars = m_load.getVars();
+    for(unsigned int i=0; i<vars.size(); i++) {
+      Register(vars[i], 0);
+      m_load_received[vars[i]] = 0;
+    }
+  }
 }
 
 
@@ -85,6 +133,21 @@ bool Relayer::Iterate()
 {
   m_iterations++;
 
+  if(m_mode == "ping")
+    return(iteratePing());
+  if(m_mode == "load")
+    return(iterateLoad());
+  if(m_mode == "relay")
+    return(iterateRelay());
+  return(true);
+}
+
+
+//---------------------------------------------------------
+// Procedure: iterateRelay()
+
+bool Relayer::iterateRelay()
+{
   unsigned int i, amt = (m_tally_recd - m_tally_sent);
   for(i=0; i<amt; i++) {
     m_tally_sent++;
@@ -117,6 +180,357 @@ bool Relayer::Iterate()
 }
 
 
+//---------------------------------------------------------
+// Procedure: iteratePing()
+//   Purpose: Run the sweep one step at a time. Each step sends pings
+//            for step_duration seconds, then waits drain_time seconds
+//            for the last replies before anything unanswered is
+//            counted as dropped.
+
+bool Relayer::iteratePing()
+{
+  if(m_sweep_done || (m_curr_step >= m_steps.size()))
+    return(true);
+
+  SweepStep& step = m_steps[m_curr_step];
+  double now = MOOSLocalTime(false);
+
+  if(step.start_time == 0) {
+    SetAppFreq(step.app_tick);
+    SetCommsFreq((unsigned int)step.comms_tick);
+    step.start_time = now;
+    Notify(m_outgoing_var+"_STEP", m_curr_step);
+  }
+
+  double elapsed = now - step.start_time;
+  if(elapsed < m_step_duration) {
+    for(unsigned int i=0; i<m_pings_per_iterate; i++)
+      sendPing(step);
+  }
+  else if(elapsed >= m_step_duration + m_drain_time) {
+    m_curr_step++;
+    if(m_curr_step >= m_steps.size()) {
+      m_sweep_done = true;
+      writeResults();
+      Notify(m_outgoing_var+"_DONE", "true");
+    }
+  }
+  return(true);
+}
+
+
+//---------------------------------------------------------
+// Procedure: iterateLoad()
+//   Purpose: Step through the vehicle counts, running the load
+//            generator for step_duration seconds at each. The
+//            generator paces itself, Iterate only reports on it.
+
+bool Relayer::iterateLoad()
+{
+  if(m_sweep_done || (m_curr_step >= m_load_vehicles.size()))
+    return(true);
+
+  if(!m_load.running() && (m_load_results.size() == m_curr_step)) {
+    map<string, unsigned long>::iterator p;
+    for(p=m_load_received.begin(); p!=m_load_received.end(); p++)
+      p->second = 0;
+    m_load.start(m_load_vehicles[m_curr_step], [this](const string& var, const string& val) {
+      Notify(var, val);
+    });
+    Notify("XRELAY_LOAD_VEHICLES", m_load_vehicles[m_curr_step]);
+    return(true);
+  }
+
+  LoadResult result = getLoadResult();
+  Notify("XRELAY_LOAD_REPORT", getLoadReport(result));
+
+  if(result.duration >= m_step_duration) {
+    m_load.stop();
+    m_load_results.push_back(getLoadResult());
+    if(m_load_verify && !allStreamsDelivered(m_load_results.back())) {
+      string warning = "No mail delivered back for a stream at vehicles=" +
+        uintToString(m_load_results.back().vehicles);
+      cerr << warning << endl;
+      Notify("XRELAY_LOAD_WARNING", warning);
+    }
+    m_curr_step++;
+    if(m_curr_step >= m_load_vehicles.size()) {
+      m_sweep_done = true;
+      writeLoadResults();
+      Notify("XRELAY_LOAD_DONE", "true");
+    }
+  }
+  return(true);
+}
+
+
+//---------------------------------------------------------
+// Procedure: getLoadResult()
+
+Relayer::LoadResult Relayer::getLoadResult() const
+{
+  LoadResult result;
+  result.vehicles = m_load.numVehicles();
+  result.duration = m_load.elapsed();
+  result.max_lag  = m_load.maxLag();
+  result.late     = m_load.lateMessages();
+  result.streams  = m_load.getStats();
+  for(unsigned int i=0; i<result.streams.size(); i++) {
+    map<string, unsigned long>::const_iterator p = m_load_received.find(result.streams[i].var);
+    result.delivered.push_back((p == m_load_received.end()) ? 0 : p->second);
+  }
+  return(result);
+}
+
+
+//---------------------------------------------------------
+// Procedure: allStreamsDelivered()
+//   Purpose: With load_verify on, every stream that sent anything in
+//            a loopback run should have had some of it delivered back.
+//            Zero means the subscription is broken, not that the
+//            MOOSDB fell behind.
+
+bool Relayer::allStreamsDelivered(const LoadResult& result) const
+{
+  for(unsigned int i=0; i<result.streams.size(); i++) {
+    if((result.streams[i].sent > 0) && (result.delivered[i] == 0))
+      return(false);
+  }
+  return(true);
+}
+
+
+//---------------------------------------------------------
+// Procedure: getLoadReport()
+//   Example: vehicles=20,node_report=80/79.8,view_polygon=160/160,
+//            max_lag=0.0004,late=0
+//      Note: Each stream is requested/achieved messages per second,
+//            with /delivered added when load_verify is on.
+
+string Relayer::getLoadReport(const LoadResult& result) const
+{
+  string report = "vehicles=" + uintToString(result.vehicles);
+  for(unsigned int i=0; i<result.streams.size(); i++) {
+    const LoadGenerator::StreamStats& stream = result.streams[i];
+    double achieved = (result.duration > 0) ? stream.sent / result.duration : 0;
+    report += "," + stream.kind + "=" + doubleToStringX(stream.requested_hz, 1) +
+      "/" + doubleToStringX(achieved, 1);
+    if(m_load_verify) {
+      double delivered = (result.duration > 0) ? result.delivered[i] / result.duration : 0;
+      report += "/" + doubleToStringX(delivered, 1);
+    }
+  }
+  report += ",max_lag=" + doubleToStringX(result.max_lag, 4);
+  report += ",late=" + uintToString(result.late);
+  return(report);
+}
+
+
+//---------------------------------------------------------
+// Procedure: buildSweep()
+//   Purpose: One step for every combination of payload size,
+//            AppTick and CommsTick.
+
+void Relayer::buildSweep()
+{
+  if(m_payload_sizes.empty())
+    m_payload_sizes.push_back(64);
+  if(m_app_ticks.empty())
+    m_app_ticks.push_back(GetAppFreq());
+  if(m_comms_ticks.empty())
+    m_comms_ticks.push_back(GetCommsFreq());
+
+  m_steps.clear();
+  for(unsigned int i=0; i<m_payload_sizes.size(); i++) {
+    for(unsigned int j=0; j<m_app_ticks.size(); j++) {
+      for(unsigned int k=0; k<m_comms_ticks.size(); k++) {
+        SweepStep step;
+        step.payload_size = m_payload_sizes[i];
+        step.app_tick     = m_app_ticks[j];
+        step.comms_tick   = m_comms_ticks[k];
+        step.start_time   = 0;
+        step.sent         = 0;
+        step.received     = 0;
+        step.duplicates   = 0;
+        step.reordered    = 0;
+        step.highest_seq  = 0;
+        m_steps.push_back(step);
+      }
+    }
+  }
+  m_curr_step  = 0;
+  m_sweep_done = false;
+}
+
+
+//---------------------------------------------------------
+// Procedure: sendPing()
+//   Purpose: Post "step=<i>,seq=<n>,sent=<time>" padded out to the
+//            step's payload size. The padding goes last so replies
+//            can be decoded from the front of the string. With
+//            pong_ticks = follow, the step's ",app=<tick>,comms=<tick>"
+//            go before the padding for the pong to apply.
+
+void Relayer::sendPing(SweepStep& step)
+{
+  char header[128];
+  if(m_pong_follows)
+    snprintf(header, sizeof(header), "step=%u,seq=%lu,sent=%.6f,app=%g,comms=%g,pad=",
+             m_curr_step, step.sent, MOOSLocalTime(false), step.app_tick, step.comms_tick);
+  else
+    snprintf(header, sizeof(header), "step=%u,seq=%lu,sent=%.6f,pad=", m_curr_step,
+             step.sent, MOOSLocalTime(false));
+
+  string payload = header;
+  if(payload.size() < step.payload_size)
+    payload.append(step.payload_size - payload.size(), 'x');
+
+  step.seen.push_back(false);
+  step.sent++;
+  Notify(m_outgoing_var, payload);
+}
+
+
+//---------------------------------------------------------
+// Procedure: followPingTicks()
+//   Purpose: In pong mode, take on the AppTick and CommsTick a ping
+//            carries, so both ends of a sweep step run at the ticks
+//            the results file reports for it.
+
+void Relayer::followPingTicks(const string& payload)
+{
+  unsigned int  step_ix;
+  unsigned long seq;
+  double        sent, app_tick, comms_tick;
+  if(sscanf(payload.c_str(), "step=%u,seq=%lu,sent=%lf,app=%lf,comms=%lf",
+            &step_ix, &seq, &sent, &app_tick, &comms_tick) != 5)
+    return;
+  if((app_tick <= 0) || (comms_tick <= 0))
+    return;
+
+  if(app_tick != m_pong_app_tick) {
+    SetAppFreq(app_tick);
+    m_pong_app_tick = app_tick;
+  }
+  if(comms_tick != m_pong_comms_tick) {
+    SetCommsFreq((unsigned int)comms_tick);
+    m_pong_comms_tick = comms_tick;
+  }
+}
+
+
+//---------------------------------------------------------
+// Procedure: handlePong()
+
+void Relayer::handlePong(const string& payload)
+{
+  double now = MOOSLocalTime(false);
+
+  unsigned int  step_ix;
+  unsigned long seq;
+  double        sent;
+  if(sscanf(payload.c_str(), "step=%u,seq=%lu,sent=%lf", &step_ix, &seq, &sent) != 3)
+    return;
+  if((step_ix >= m_steps.size()) || (seq >= m_steps[step_ix].seen.size()))
+    return;
+
+  SweepStep& step = m_steps[step_ix];
+  if(step.seen[seq]) {
+    step.duplicates++;
+    return;
+  }
+  if((step.received > 0) && (seq < step.highest_seq))
+    step.reordered++;
+  else
+    step.highest_seq = seq;
+
+  step.seen[seq] = true;
+  step.received++;
+  step.latency.add(now - sent);
+}
+
+
+//---------------------------------------------------------
+// Procedure: writeResults()
+
+bool Relayer::writeResults() const
+{
+  ofstream out(m_results_file.c_str());
+  if(!out.is_open())
+    return(false);
+
+  out << "{\n";
+  out << "  \"outgoing_var\": \"" << m_outgoing_var << "\",\n";
+  out << "  \"incoming_var\": \"" << m_incoming_var << "\",\n";
+  out << "  \"step_duration\": " << m_step_duration << ",\n";
+  out << "  \"drain_time\": " << m_drain_time << ",\n";
+  out << "  \"pings_per_iterate\": " << m_pings_per_iterate << ",\n";
+  out << "  \"pong_ticks\": \"" << (m_pong_follows ? "follow" : "fixed") << "\",\n";
+  out << "  \"steps\": [";
+  for(unsigned int i=0; i<m_steps.size(); i++) {
+    const SweepStep& step = m_steps[i];
+    out << ((i == 0) ? "\n" : ",\n");
+    out << "    {\"payload_bytes\": " << step.payload_size
+        << ", \"app_tick\": " << step.app_tick
+        << ", \"comms_tick\": " << step.comms_tick;
+    if(m_pong_follows)
+      out << ", \"pong_app_tick\": " << step.app_tick
+          << ", \"pong_comms_tick\": " << step.comms_tick;
+    out << ", \"sent\": " << step.sent
+        << ", \"received\": " << step.received
+        << ", \"dropped\": " << (step.sent - step.received)
+        << ", \"duplicates\": " << step.duplicates
+        << ", \"reordered\": " << step.reordered
+        << ", \"send_rate_hz\": " << (step.sent / m_step_duration)
+        << ",\n     \"latency\": " << step.latency.getJSON() << "}";
+  }
+  out << "\n  ]\n}\n";
+  return(out.good());
+}
+
+
+//---------------------------------------------------------
+// Procedure: writeLoadResults()
+
+bool Relayer::writeLoadResults() const
+{
+  ofstream out(m_results_file.c_str());
+  if(!out.is_open())
+    return(false);
+
+  out << "{\n";
+  out << "  \"step_duration\": " << m_step_duration << ",\n";
+  out << "  \"load_verify\": " << (m_load_verify ? "true" : "false") << ",\n";
+  out << "  \"steps\": [";
+  for(unsigned int i=0; i<m_load_results.size(); i++) {
+    const LoadResult& result = m_load_results[i];
+    out << ((i == 0) ? "\n" : ",\n");
+    out << "    {\"vehicles\": " << result.vehicles
+        << ", \"duration\": " << result.duration
+        << ", \"max_lag_ms\": " << result.max_lag * 1000
+        << ", \"late\": " << result.late;
+    if(m_load_verify)
+      out << ", \"all_delivered\": " << (allStreamsDelivered(result) ? "true" : "false");
+    out << ", \"streams\": [";
+    for(unsigned int j=0; j<result.streams.size(); j++) {
+      const LoadGenerator::StreamStats& stream = result.streams[j];
+      double secs = (result.duration > 0) ? result.duration : 1;
+      out << ((j == 0) ? "\n" : ",\n");
+      out << "      {\"kind\": \"" << stream.kind << "\""
+          << ", \"var\": \"" << stream.var << "\""
+          << ", \"requested_hz\": " << stream.requested_hz
+          << ", \"achieved_hz\": " << stream.sent / secs
+          << ", \"bytes_per_sec\": " << stream.bytes / secs;
+      if(m_load_verify)
+        out << ", \"delivered_hz\": " << result.delivered[j] / secs;
+      out << "}";
+    }
+    out << "]}";
+  }
+  out << "\n  ]\n}\n";
+  return(out.good());
+}
+
 
 //---------------------------------------------------------
 // Procedure: OnStartUp()
@@ -130,16 +544,81 @@ bool Relayer::OnStartUp()
   STRING_LIST::iterator p;
   for(p = sParams.begin();p!=sParams.end();p++) {
     string line  = *p;
+    string orig  = line;
     string param = tolower(biteStringX(line, '='));
     string value = line;
 
+    bool handled = true;
     if(param == "incoming_var")
       m_incoming_var = value;
     
     else if(param == "outgoing_var")
       m_outgoing_var = value;
+
+    else if(param == "mode") {
+      value = tolower(value);
+      handled = ((value == "relay") || (value == "ping") || (value == "pong") ||
+                 (value == "load"));
+      if(handled)
+        m_mode = value;
+    }
+    else if(param == "payload_sizes") {
+      m_payload_sizes.clear();
+      vector<string> svector = parseString(value, ',');
+      for(unsigned int i=0; handled && (i<svector.size()); i++) {
+        unsigned int size = 0;
+        handled = setUIntOnString(size, svector[i]);
+        m_payload_sizes.push_back(size);
+      }
+    }
+    else if((param == "app_ticks") || (param == "comms_ticks")) {
+      vector<double>& ticks = (param == "app_ticks") ? m_app_ticks : m_comms_ticks;
+      ticks.clear();
+      vector<string> svector = parseString(value, ',');
+      for(unsigned int i=0; handled && (i<svector.size()); i++) {
+        double tick = 0;
+        handled = setPosDoubleOnString(tick, svector[i]);
+        ticks.push_back(tick);
+      }
+    }
+    else if(param == "step_duration")
+      handled = setPosDoubleOnString(m_step_duration, value);
+    else if(param == "drain_time")
+      handled = setNonNegDoubleOnString(m_drain_time, value);
+    else if(param == "pings_per_iterate")
+      handled = setUIntOnString(m_pings_per_iterate, value);
+    else if(param == "results_file")
+      m_results_file = value;
+    else if(param == "pong_ticks") {
+      value = tolower(value);
+      handled = ((value == "follow") || (value == "fixed"));
+      m_pong_follows = (value == "follow");
+    }
+
+    else if(param == "load_vehicles") {
+      m_load_vehicles.clear();
+      vector<string> svector = parseString(value, ',');
+      for(unsigned int i=0; handled && (i<svector.size()); i++) {
+        unsigned int count = 0;
+        handled = setUIntOnString(count, svector[i]) && (count > 0);
+        m_load_vehicles.push_back(count);
+      }
+    }
+    else if(param == "load_verify")
+      handled = setBooleanOnString(m_load_verify, value);
+    else if((param == "node_report") || (param == "sensor_reading") ||
+            (param == "view_polygon") || (param == "swimmer_alert"))
+      handled = m_load.setStream(param, value);
+
+    if(!handled)
+      cerr << "Unhandled config line: " << orig << endl;
   }
 
+  if(m_mode == "ping")
+    buildSweep();
+  if((m_mode == "load") && m_load_vehicles.empty())
+    m_load_vehicles.push_back(10);
+
   RegisterVariables();
   return(true);
 }
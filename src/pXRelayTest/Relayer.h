@@ -23,13 +23,18 @@
 #ifndef P_RELAY_VAR_HEADER
 #define P_RELAY_VAR_HEADER
 
+#include <string>
+#include <vector>
+#include <map>
 #include "MOOS/libMOOS/MOOSLib.h"
+#include "LatencyHistogram.h"
+#include "LoadGenerator.h"
 
 class Relayer : public CMOOSApp
 {
  public:
   Relayer();
-  virtual ~Relayer() {};
+  virtual ~Relayer();
 
   bool OnNewMail(MOOSMSG_LIST &NewMail);
   bool Iterate();
@@ -39,6 +44,46 @@ class Relayer : public CMOOSApp
 
   void setIncomingVar(std::string s) {m_incoming_var=s;};
   void setOutgoingVar(std::string s) {m_outgoing_var=s;};
+  void setMode(std::string s)        {m_mode=s;};
+
+ protected:
+  // One payload size and AppTick/CommsTick setting of a ping sweep
+  struct SweepStep {
+    unsigned int  payload_size;
+    double        app_tick;
+    double        comms_tick;
+    double        start_time;
+    unsigned long sent;
+    unsigned long received;
+    unsigned long duplicates;
+    unsigned long reordered;
+    unsigned long highest_seq;
+    std::vector<bool> seen;
+    LatencyHistogram  latency;
+  };
+
+  // Rates seen during one load generator step
+  struct LoadResult {
+    unsigned int  vehicles;
+    double        duration;
+    double        max_lag;
+    unsigned long late;
+    std::vector<LoadGenerator::StreamStats> streams;
+    std::vector<unsigned long> delivered;
+  };
+
+  bool iterateRelay();
+  bool iteratePing();
+  bool iterateLoad();
+  LoadResult getLoadResult() const;
+  std::string getLoadReport(const LoadResult& result) const;
+  bool allStreamsDelivered(const LoadResult& result) const;
+  void buildSweep();
+  void sendPing(SweepStep& step);
+  void followPingTicks(const std::string& payload);
+  void handlePong(const std::string& payload);
+  bool writeResults() const;
+  bool writeLoadResults() const;
 
  protected:
   unsigned long int m_tally_recd;
@@ -50,6 +95,38 @@ class Relayer : public CMOOSApp
 
   double            m_start_time_postings;
   double            m_start_time_iterations;
+
+  // Benchmark configuration. In ping mode, OUTGOING_VAR carries
+  // timestamped pings and the replies come back on INCOMING_VAR. In
+  // pong mode every INCOMING_VAR is echoed straight to OUTGOING_VAR.
+  std::string       m_mode;
+  std::vector<unsigned int> m_payload_sizes;
+  std::vector<double>       m_app_ticks;
+  std::vector<double>       m_comms_ticks;
+  double            m_step_duration;
+  double            m_drain_time;
+  unsigned int      m_pings_per_iterate;
+  std::string       m_results_file;
+  // Whether pings carry the step's ticks for the pong to run at too
+  // (pong_ticks = follow), or the pong keeps its own (fixed)
+  bool              m_pong_follows;
+  double            m_pong_app_tick;
+  double            m_pong_comms_tick;
+
+  // Load generator mode: publish the mix from m_load for each vehicle
+  // count in turn, step_duration seconds each. With load_verify the
+  // generated vars are subscribed to as well, to count what the MOOSDB
+  // actually delivers.
+  LoadGenerator     m_load;
+  std::vector<unsigned int> m_load_vehicles;
+  bool              m_load_verify;
+  std::map<std::string, unsigned long> m_load_received;
+  std::vector<LoadResult> m_load_results;
+
+  // Benchmark state
+  std::vector<SweepStep> m_steps;
+  unsigned int      m_curr_step;
+  bool              m_sweep_done;
 };
 
 #endif 
@@ -39,6 +39,19 @@ void showSynopsis()
   blk("  example of the MOOS publish-subscribe architecture. It is     ");
   blk("  typically run in conjunction with another instance of the same");
   blk("  process to send mail back and forth to each other.            ");
+  blk("                                                                ");
+  blk("  With mode=ping and a second instance running mode=pong it is  ");
+  blk("  a round-trip benchmark for the MOOSDB. Pings carry a sequence ");
+  blk("  number and send time, and the round-trip latency, drops,      ");
+  blk("  duplicates and reordering are measured while sweeping payload ");
+  blk("  sizes and AppTick/CommsTick. Results are written to a JSON    ");
+  blk("  file when the sweep finishes.                                 ");
+  blk("                                                                ");
+  blk("  With mode=load it instead publishes the message mix of an     ");
+  blk("  N-vehicle mission (NODE_REPORT, SECTOR_SENSOR_READING,        ");
+  blk("  VIEW_POLYGON bursts and SWIMMER_ALERT) from a separate paced  ");
+  blk("  thread, and reports requested versus achieved rates for each  ");
+  blk("  vehicle count in load_vehicles.                               ");
 }
 
 //----------------------------------------------------------------
@@ -65,6 +78,9 @@ void showHelpAndExit()
   blk("      Use <varname> as the Relay incoming variable              ");
   mag("  --interface, -i                                               ");
   blk("      Display MOOS publications and subscriptions.              ");
+  mag("  --mode","=<relay|ping|pong|load>                              ");
+  blk("      Run as a plain relay (default), a benchmark pinger, the   ");
+  blk("      echoing side of a benchmark or a load generator.          ");
   mag("  --out","=<varname>                                            ");
   blk("      Use <varname> as the Relay outgoing variable              ");
   blk("                                                                ");
@@ -92,6 +108,35 @@ void showExampleConfigAndExit()
   blk("                                                                ");
   blk("  OUTGOING_VAR = APPLES                                         ");
   blk("  INCOMING_VAR = PEARS                                          ");
+  blk("                                                                ");
+  blk("  // relay, ping, pong or load (Default is relay)               ");
+  blk("  mode = relay                                                  ");
+  blk("                                                                ");
+  blk("  // Ping mode only. The sweep runs every combination of        ");
+  blk("  // payload size (bytes), AppTick and CommsTick. The ticks     ");
+  blk("  // default to the ones above.                                 ");
+  blk("  payload_sizes     = 64,1024,16384                             ");
+  blk("  app_ticks         = 4,20,50                                   ");
+  blk("  comms_ticks       = 4,20,50                                   ");
+  blk("  step_duration     = 10     // seconds of pings per step       ");
+  blk("  drain_time        = 2      // seconds to wait for replies     ");
+  blk("  pings_per_iterate = 1                                         ");
+  blk("  results_file      = xrelay_results.json                       ");
+  blk("  // follow: pings carry each step's ticks and the pong runs    ");
+  blk("  // at them too. fixed: the pong keeps its own AppTick and     ");
+  blk("  // CommsTick. Either way the results file records which.      ");
+  blk("  pong_ticks        = follow                                    ");
+  blk("                                                                ");
+  blk("  // Load mode only. Each vehicle count runs for step_duration  ");
+  blk("  // seconds. Stream rates are Hz per vehicle, except for       ");
+  blk("  // swimmer_alert. burst is messages per event and size pads   ");
+  blk("  // each message to at least that many bytes.                  ");
+  blk("  load_vehicles  = 10,20,50,100                                 ");
+  blk("  node_report    = rate=4                                       ");
+  blk("  sensor_reading = rate=4                                       ");
+  blk("  view_polygon   = rate=1, burst=8                              ");
+  blk("  swimmer_alert  = rate=0.2, var=SWIMMER_ALERT                  ");
+  blk("  load_verify    = false  // subscribe to count delivered msgs  ");
   blk("}                                                               ");
   blk("                                                                ");
   exit(0);
@@ -120,6 +165,18 @@ void showInterfaceAndExit()
   blk("  Whatever variable is specified by the OUTGOING_VAR            ");
   blk("  configuration parameter.                                      ");
   blk("                                                                ");
+  blk("  In ping mode also:                                            ");
+  blk("  <OUTGOING_VAR>_STEP = 3    (index of the sweep step started)  ");
+  blk("  <OUTGOING_VAR>_DONE = true (the results file was written)     ");
+  blk("                                                                ");
+  blk("  In load mode also the generated vars, and:                    ");
+  blk("  XRELAY_LOAD_VEHICLES = 20                                     ");
+  blk("  XRELAY_LOAD_REPORT   = vehicles=20,node_report=80/79.9,...,   ");
+  blk("                         max_lag=0.0004,late=0                  ");
+  blk("  XRELAY_LOAD_WARNING  = No mail delivered back for a stream... ");
+  blk("                         (load_verify, a step delivered 0 msgs) ");
+  blk("  XRELAY_LOAD_DONE     = true                                   ");
+  blk("                                                                ");
   exit(0);
 }
 
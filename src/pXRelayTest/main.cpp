@@ -34,6 +34,7 @@ int main(int argc, char *argv[])
   string run_command = argv[0];
   string incoming_var;
   string outgoing_var;
+  string mode;
 
   for(int i=1; i<argc; i++) {
     string argi = argv[i];
@@ -51,6 +52,8 @@ int main(int argc, char *argv[])
       incoming_var = argi.substr(5);
     else if(strBegins(argi, "--out="))
       outgoing_var = argi.substr(6);
+    else if(strBegins(argi, "--mode="))
+      mode = tolower(argi.substr(7));
     else if(i==2)
       run_command = argi;
   }
@@ -63,6 +66,8 @@ int main(int argc, char *argv[])
     relayer.setIncomingVar(incoming_var);
   if(outgoing_var != "")
     relayer.setOutgoingVar(outgoing_var);
+  if(mode != "")
+    relayer.setMode(mode);
 
   relayer.Run(run_command.c_str(), mission_file.c_str());
 
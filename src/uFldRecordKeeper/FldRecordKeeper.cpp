@@ -9,14 +9,28 @@
 #include "MBUtils.h"
 #include "ACTable.h"
 #include "FldRecordKeeper.h"
+#include "general_utils.h"
+#include "XYFormatUtilsPoly.h"
 
 using namespace std;
 
 //---------------------------------------------------------
 // Constructor()
 
-FldRecordKeeper::FldRecordKeeper()
+FldRecordKeeper::FldRecordKeeper() : m_recorder(m_store, m_score)
 {
+  m_store_file     = "record_keeper.trj";
+  m_flush_interval = 10;
+  m_score_var      = "MISSION_SCORE";
+  m_summary_file   = "record_keeper_summary.csv";
+  m_coverage_file  = "";
+  m_heatmap_file   = "";
+
+  m_last_flush_time = 0;
+  m_flush_ok        = true;
+  m_summary_written = false;
+  m_node_reports    = 0;
+  m_bad_reports     = 0;
 }
 
 //---------------------------------------------------------
@@ -24,6 +38,12 @@ FldRecordKeeper::FldRecordKeeper()
 
 FldRecordKeeper::~FldRecordKeeper()
 {
+  // Whatever arrived since the last periodic flush
+  if(m_store_file != "")
+    m_store.flush(m_store_file);
+  // Missions cut short never post MISSION_EVALUATED
+  if(!m_summary_written)
+    writeSummary();
 }
 
 //---------------------------------------------------------
@@ -48,8 +68,21 @@ bool FldRecordKeeper::OnNewMail(MOOSMSG_LIST &NewMail)
     bool   mstr  = msg.IsString();
 #endif
 
-     if(key == "FOO") 
-       cout << "great!";
+     if(key == "NODE_REPORT")
+       handleNodeReport(msg);
+     else if((key == "SWIMMER_ALERT") || strBegins(key, "SWIMMER_ALERT_"))
+       handleSwimmerAlert(msg);
+     else if(key == "FOUND_SWIMMER")
+       handleFoundSwimmer(msg);
+     else if(key == "RESCUE_REGION")
+       handleRescueRegion(msg);
+     else if(key == "MISSION_EVALUATED") {
+       if(tolower(msg.GetString()) == "true") {
+         writeSummary();
+         if(m_store_file != "")
+           flushStore();
+       }
+     }
 
      else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
        reportRunWarning("Unhandled Mail: " + key);
@@ -74,7 +107,14 @@ bool FldRecordKeeper::OnConnectToServer()
 bool FldRecordKeeper::Iterate()
 {
   AppCastingMOOSApp::Iterate();
-  // Do your thing here!
+
+  if((m_flush_interval > 0) && (m_store_file != "") &&
+     ((m_curr_time - m_last_flush_time) >= m_flush_interval))
+    flushStore();
+
+  if((m_score_var != "") && m_score.changed())
+    Notify(m_score_var, m_score.getSpec());
+
   AppCastingMOOSApp::PostReport();
   return(true);
 }
@@ -100,18 +140,42 @@ bool FldRecordKeeper::OnStartUp()
     string value = line;
 
     bool handled = false;
-    if(param == "foo") {
+    if(param == "store_file") {
+      m_store_file = value;
+      handled = true;
+    }
+    else if(param == "flush_interval")
+      handled = setNonNegDoubleOnString(m_flush_interval, value);
+    else if(param == "score_var") {
+      m_score_var = value;
+      handled = true;
+    }
+    else if(param == "summary_file") {
+      m_summary_file = value;
+      handled = true;
+    }
+    else if(param == "coverage_file") {
+      m_coverage_file = value;
       handled = true;
     }
-    else if(param == "bar") {
+    else if(param == "heatmap_file") {
+      m_heatmap_file = value;
       handled = true;
     }
+    else if(param == "coverage_cell_size") {
+      double cell_size = 0;
+      handled = setPosDoubleOnString(cell_size, value);
+      if(handled)
+        m_score.setCellSize(cell_size);
+    }
 
     if(!handled)
       reportUnhandledConfigWarning(orig);
 
   }
   
+  m_last_flush_time = MOOSTime();
+
   registerVariables();	
   return(true);
 }
@@ -122,7 +186,137 @@ bool FldRecordKeeper::OnStartUp()
 void FldRecordKeeper::registerVariables()
 {
   AppCastingMOOSApp::RegisterVariables();
-  // Register("FOOBAR", 0);
+  Register("NODE_REPORT", 0);
+  Register("FOUND_SWIMMER", 0);
+  Register("RESCUE_REGION", 0);
+  Register("MISSION_EVALUATED", 0);
+  // uFldRescueMgr posts alerts per vehicle, e.g. SWIMMER_ALERT_ABE
+  Register("SWIMMER_ALERT", 0);
+  Register("SWIMMER_ALERT_*", "*", 0);
+}
+
+//---------------------------------------------------------
+// Procedure: handleNodeReport()
+//   Example: NAME=abe,TYPE=KAYAK,TIME=1234,X=100,Y=200,HDG=45,...
+
+void FldRecordKeeper::handleNodeReport(CMOOSMsg &msg)
+{
+  m_node_reports++;
+  NodeReportFields fields;
+  if(!scanNodeReport(msg.m_sVal, fields) || !fields.has_x || !fields.has_y) {
+    m_bad_reports++;
+    return;
+  }
+
+  string vname(fields.name);
+  uint32_t id = m_store.entityId(vname, TrajectoryStore::VEHICLE);
+  m_store.append(id, msg.GetTime(), fields.x, fields.y, fields.hdg);
+  m_score.addPosition(vname, fields.x, fields.y);
+}
+
+//---------------------------------------------------------
+// Procedure: handleSwimmerAlert()
+//   Example: type=reg,x=42,y=-31,id=07
+//     Note: Each swimmer is alerted to every vehicle, only the
+//           first alert for an id is recorded
+
+void FldRecordKeeper::handleSwimmerAlert(CMOOSMsg &msg)
+{
+  string id_str;
+  double x = 0;
+  double y = 0;
+  bool   ok_x = false;
+  bool   ok_y = false;
+
+  vector<string> svector = parseString(msg.GetString(), ',');
+  for(unsigned int i=0; i<svector.size(); i++) {
+    string param = tolower(biteStringX(svector[i], '='));
+    string value = svector[i];
+    if(param == "id")
+      id_str = value;
+    else if(param == "x")
+      ok_x = setDoubleOnString(x, value);
+    else if(param == "y")
+      ok_y = setDoubleOnString(y, value);
+  }
+  unsigned int id = 0;
+  if(!setUIntOnString(id, id_str) || !ok_x || !ok_y)
+    return;
+  m_recorder.addAlert(id, id_str, msg.GetTime(), x, y);
+}
+
+//---------------------------------------------------------
+// Procedure: handleFoundSwimmer()
+//   Example: id=07,finder=abe
+
+void FldRecordKeeper::handleFoundSwimmer(CMOOSMsg &msg)
+{
+  string id_str;
+  string finder;
+
+  vector<string> svector = parseString(msg.GetString(), ',');
+  for(unsigned int i=0; i<svector.size(); i++) {
+    string param = tolower(biteStringX(svector[i], '='));
+    string value = svector[i];
+    if(param == "id")
+      id_str = value;
+    else if((param == "finder") || (param == "vname"))
+      finder = value;
+  }
+  unsigned int id = 0;
+  if(!setUIntOnString(id, id_str))
+    return;
+  // A rescue can be reported before we saw the alert
+  m_recorder.addRescue(id, id_str, msg.GetTime(), finder);
+}
+
+//---------------------------------------------------------
+// Procedure: handleRescueRegion()
+//   Example: pts={60,10:-75.5,-54.3:-37,-135.6:98.6,-71.3},label=...
+
+void FldRecordKeeper::handleRescueRegion(CMOOSMsg &msg)
+{
+  XYPolygon region = string2Poly(msg.GetString());
+  if(region.size() < 3) {
+    reportRunWarning("Unable to parse RESCUE_REGION");
+    return;
+  }
+  retractRunWarning("Unable to parse RESCUE_REGION");
+  m_score.setRegion(region);
+}
+
+//---------------------------------------------------------
+// Procedure: flushStore()
+
+void FldRecordKeeper::flushStore()
+{
+  m_last_flush_time = m_curr_time;
+  bool ok = m_store.flush(m_store_file);
+  if(!ok && m_flush_ok)
+    reportRunWarning("Unable to write store_file: " + m_store_file);
+  else if(ok && !m_flush_ok)
+    retractRunWarning("Unable to write store_file: " + m_store_file);
+  m_flush_ok = ok;
+}
+
+//---------------------------------------------------------
+// Procedure: writeSummary()
+
+void FldRecordKeeper::writeSummary()
+{
+  const CoverageGrid& coverage = m_score.teamCoverageGrid();
+  if((m_coverage_file != "") && !coverage.save(m_coverage_file))
+    reportRunWarning("Unable to write coverage_file: " + m_coverage_file);
+  if((m_heatmap_file != "") && !coverage.writeHeatmap(m_heatmap_file))
+    reportRunWarning("Unable to write heatmap_file: " + m_heatmap_file);
+
+  if(m_summary_file == "")
+    return;
+  m_summary_written = m_score.writeSummary(m_summary_file);
+  if(!m_summary_written)
+    reportRunWarning("Unable to write summary_file: " + m_summary_file);
+  else
+    reportEvent("Wrote summary to " + m_summary_file);
 }
 
 
@@ -132,13 +326,39 @@ void FldRecordKeeper::registerVariables()
 bool FldRecordKeeper::buildReport() 
 {
   m_msgs << "============================================" << endl;
-  m_msgs << "File:                                       " << endl;
+  m_msgs << "File: FldRecordKeeper.cpp                   " << endl;
   m_msgs << "============================================" << endl;
 
-  ACTable actab(4);
-  actab << "Alpha | Bravo | Charlie | Delta";
+  m_msgs << "Store file:     " << m_store_file << endl;
+  m_msgs << "Bytes flushed:  " << m_store.bytesFlushed() << endl;
+  m_msgs << "Node reports:   " << m_node_reports
+         << " (unparsed: " << m_bad_reports << ")" << endl;
+  m_msgs << "Swimmers:       " << m_recorder.swimmers().size()
+         << " (rescued: " << m_store.rescues().size() << ")" << endl;
+  m_msgs << "Team coverage:  " << doubleToStringX(m_score.teamCoverage(), 3)
+         << endl;
+  m_msgs << "Summary file:   " << m_summary_file
+         << (m_summary_written ? " (written)" : "") << endl;
+  m_msgs << endl;
+
+  ACTable actab(6);
+  actab << "Vehicle | Samples | Rescues | Mean TTR | Path Len | Coverage";
   actab.addHeaderLines();
-  actab << "one" << "two" << "three" << "four";
+  for(uint32_t id=0; id<m_store.numEntities(); id++) {
+    if(m_store.kind(id) != TrajectoryStore::VEHICLE)
+      continue;
+    const string& vname = m_store.name(id);
+    ScoreEngine::VehicleScore score;
+    map<string, ScoreEngine::VehicleScore>::const_iterator it =
+      m_score.vehicles().find(vname);
+    if(it != m_score.vehicles().end())
+      score = it->second;
+    actab << vname << uintToString(m_store.numSamples(id))
+          << uintToString(score.rescues)
+          << doubleToStringX(ScoreEngine::meanTimeToRescue(score), 1)
+          << doubleToStringX(score.path_length, 1)
+          << doubleToStringX(score.coverage.coverage(), 3);
+  }
   m_msgs << actab.getFormattedString();
 
   return(true);
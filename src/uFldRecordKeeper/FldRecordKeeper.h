@@ -8,7 +8,12 @@
 #ifndef FldRecordKeeper_HEADER
 #define FldRecordKeeper_HEADER
 
+#include <string>
+#include <vector>
 #include "MOOS/libMOOS/Thirdparty/AppCasting/AppCastingMOOSApp.h"
+#include "trajectory_store.h"
+#include "score_engine.h"
+#include "swimmer_recorder.h"
 
 class FldRecordKeeper : public AppCastingMOOSApp
 {
@@ -27,10 +32,35 @@ class FldRecordKeeper : public AppCastingMOOSApp
 
  protected:
    void registerVariables();
+   void handleNodeReport(CMOOSMsg &msg);
+   void handleSwimmerAlert(CMOOSMsg &msg);
+   void handleFoundSwimmer(CMOOSMsg &msg);
+   void handleRescueRegion(CMOOSMsg &msg);
+   void flushStore();
+   void writeSummary();
 
  private: // Configuration variables
+   std::string m_store_file;
+   double      m_flush_interval;
+   std::string m_score_var;
+   std::string m_summary_file;
+   std::string m_coverage_file;  // Team CoverageGrid, binary
+   std::string m_heatmap_file;   // Team visit counts, CSV
 
  private: // State variables
+   TrajectoryStore m_store;
+   double          m_last_flush_time;
+   bool            m_flush_ok;
+
+   ScoreEngine     m_score;
+   bool            m_summary_written;
+
+   // Swimmers by id (as given in SWIMMER_ALERT), recorded into the
+   // two above
+   SwimmerRecorder m_recorder;
+
+   unsigned int m_node_reports;
+   unsigned int m_bad_reports;
 };
 
 #endif 
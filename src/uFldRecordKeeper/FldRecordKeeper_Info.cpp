@@ -20,11 +20,14 @@ void showSynopsis()
 {
   blk("SYNOPSIS:                                                       ");
   blk("------------------------------------                            ");
-  blk("  The uFldRecordKeeper application is used for               ");
-  blk("                                                                ");
-  blk("                                                                ");
-  blk("                                                                ");
-  blk("                                                                ");
+  blk("  The uFldRecordKeeper application is used for keeping the     ");
+  blk("  position history of every vehicle and swimmer, and which     ");
+  blk("  swimmers were rescued by whom. Histories are held in memory  ");
+  blk("  as per-entity columns and appended to a compact binary       ");
+  blk("  store_file every flush_interval seconds for later scoring.   ");
+  blk("  Rescues, time-to-rescue, path length and region coverage are ");
+  blk("  scored as reports arrive, posted to score_var, and written   ");
+  blk("  to summary_file when the mission is evaluated.              ");
 }
 
 //----------------------------------------------------------------
@@ -74,6 +77,14 @@ void showExampleConfigAndExit()
   blk("  AppTick   = 4                                                 ");
   blk("  CommsTick = 4                                                 ");
   blk("                                                                ");
+  blk("  store_file     = record_keeper.trj  // empty disables writing ");
+  blk("  flush_interval = 10                 // secs, 0 = only at exit ");
+  blk("                                                                ");
+  blk("  score_var          = MISSION_SCORE                            ");
+  blk("  summary_file       = record_keeper_summary.csv                ");
+  blk("  coverage_cell_size = 5              // meters                 ");
+  blk("  coverage_file      = team_coverage.cvg  // binary, optional   ");
+  blk("  heatmap_file       = team_heatmap.csv   // optional           ");
   blk("}                                                               ");
   blk("                                                                ");
   exit(0);
@@ -94,12 +105,17 @@ void showInterfaceAndExit()
   blk("                                                                ");
   blk("SUBSCRIPTIONS:                                                  ");
   blk("------------------------------------                            ");
-  blk("  NODE_MESSAGE = src_node=alpha,dest_node=bravo,var_name=FOO,   ");
-  blk("                 string_val=BAR                                 ");
+  blk("  NODE_REPORT     = NAME=abe,X=100,Y=200,HDG=45,...           ");
+  blk("  SWIMMER_ALERT   = type=reg,x=42,y=-31,id=07                   ");
+  blk("  SWIMMER_ALERT_* = (same, as posted per vehicle)               ");
+  blk("  FOUND_SWIMMER   = id=07,finder=abe                            ");
+  blk("  RESCUE_REGION   = pts={60,10:-75.5,-54.3:-37,-135.6}          ");
+  blk("  MISSION_EVALUATED = true                                      ");
   blk("                                                                ");
   blk("PUBLICATIONS:                                                   ");
   blk("------------------------------------                            ");
-  blk("  Publications are determined by the node message content.      ");
+  blk("  MISSION_SCORE = rescues=3,swimmers=12,mean_ttr=41.20,         ");
+  blk("                  coverage=0.3120,path_len=1804.6               ");
   blk("                                                                ");
   exit(0);
 }
@@ -0,0 +1,282 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LockstepClock.cpp                               */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#include <iterator>
+#include "MBUtils.h"
+#include "ACTable.h"
+#include "LockstepClock.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// Constructor()
+
+LockstepClock::LockstepClock()
+{
+  m_step_size   = 0.25;
+  m_ack_timeout = 2.0;
+  m_max_steps   = 0;
+
+  m_step            = 0;
+  m_sim_start_time  = 0;
+  m_tick_post_time  = 0;
+  m_first_tick_time = 0;
+  m_total_timeouts  = 0;
+  m_total_acks      = 0;
+  m_finished        = false;
+}
+
+//---------------------------------------------------------
+// Destructor
+
+LockstepClock::~LockstepClock()
+{
+}
+
+//---------------------------------------------------------
+// Procedure: OnNewMail()
+
+bool LockstepClock::OnNewMail(MOOSMSG_LIST &NewMail)
+{
+  AppCastingMOOSApp::OnNewMail(NewMail);
+
+  MOOSMSG_LIST::iterator p;
+  for(p=NewMail.begin(); p!=NewMail.end(); p++) {
+    CMOOSMsg &msg = *p;
+    string key    = msg.GetKey();
+
+    if(key == "LOCKSTEP_ACK")
+      processAck(msg);
+
+    else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
+      reportRunWarning("Unhandled Mail: " + key);
+  }
+
+  // Mail is comms driven (see OnStartUp), so the next step goes out as
+  // soon as the last ack for this one is in, not on the next AppTick
+  if((m_step > 0) && !m_finished && allAcked())
+    postTick();
+
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: OnConnectToServer()
+
+bool LockstepClock::OnConnectToServer()
+{
+  registerVariables();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: Iterate()
+//            happens AppTick times per second
+
+bool LockstepClock::Iterate()
+{
+  AppCastingMOOSApp::Iterate();
+
+  if(!m_finished) {
+    // With no participants this degenerates to a plain AppTick clock
+    if((m_step == 0) || m_participants.empty() || allAcked())
+      postTick();
+    else if((m_ack_timeout > 0) &&
+            ((MOOSTime() - m_tick_post_time) > m_ack_timeout)) {
+      m_total_timeouts++;
+      reportEvent("Step " + uintToString(m_step) + " timed out waiting for acks");
+      postTick();
+    }
+  }
+
+  AppCastingMOOSApp::PostReport();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: OnStartUp()
+//            happens before connection is open
+
+bool LockstepClock::OnStartUp()
+{
+  AppCastingMOOSApp::OnStartUp();
+
+  STRING_LIST sParams;
+  m_MissionReader.EnableVerbatimQuoting(false);
+  if(!m_MissionReader.GetConfiguration(GetAppName(), sParams))
+    reportConfigWarning("No config block found for " + GetAppName());
+
+  STRING_LIST::iterator p;
+  for(p=sParams.begin(); p!=sParams.end(); p++) {
+    string orig  = *p;
+    string line  = *p;
+    string param = tolower(biteStringX(line, '='));
+    string value = line;
+
+    bool handled = false;
+    if(param == "participants") {
+      // Colon separated as well, like the VNAMES the launch scripts pass
+      vector<string> vnames = parseString(findReplace(value, ':', ','), ',');
+      for(unsigned int i=0; i<vnames.size(); i++) {
+        string vname = tolower(stripBlankEnds(vnames[i]));
+        if(vname != "")
+          m_participants[vname] = 0;
+      }
+      handled = !vnames.empty();
+    }
+    else if(param == "step_size") {
+      handled = setPosDoubleOnString(m_step_size, value);
+    }
+    else if(param == "ack_timeout") {
+      handled = setNonNegDoubleOnString(m_ack_timeout, value);
+    }
+    else if(param == "max_steps") {
+      int max_steps = 0;
+      handled = setIntOnString(max_steps, value) && (max_steps >= 0);
+      if(handled)
+        m_max_steps = max_steps;
+    }
+
+    if(!handled)
+      reportUnhandledConfigWarning(orig);
+  }
+
+  if(m_participants.empty())
+    reportConfigWarning("No participants given, ticking once per AppTick");
+
+  // Acks must be handled when they arrive, not on the next AppTick
+  SetIterateMode(REGULAR_ITERATE_AND_COMMS_DRIVEN_MAIL);
+
+  registerVariables();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: registerVariables()
+
+void LockstepClock::registerVariables()
+{
+  AppCastingMOOSApp::RegisterVariables();
+  Register("LOCKSTEP_ACK", 0);
+}
+
+//---------------------------------------------------------
+// Procedure: processAck()
+//   Purpose: Note that a participant finished a step
+//    Format: "vname=abe,step=12"
+
+void LockstepClock::processAck(CMOOSMsg& msg)
+{
+  string vname;
+  int step = -1;
+
+  vector<string> mvector = parseString(msg.GetString(), ',');
+  for(unsigned int i=0; i<mvector.size(); i++) {
+    string param = tolower(biteStringX(mvector[i], '='));
+    string value = mvector[i];
+    if(param == "vname")
+      vname = tolower(value);
+    else if(param == "step")
+      setIntOnString(step, value);
+  }
+
+  map<string, unsigned int>::iterator q = m_participants.find(vname);
+  if(q == m_participants.end()) {
+    reportRunWarning("Ack from unknown participant: " + vname);
+    return;
+  }
+  if((step > 0) && ((unsigned int)(step) > q->second)) {
+    q->second = step;
+    m_total_acks++;
+  }
+}
+
+//---------------------------------------------------------
+// Procedure: allAcked()
+
+bool LockstepClock::allAcked() const
+{
+  if(m_participants.empty())
+    return(false);
+
+  map<string, unsigned int>::const_iterator q;
+  for(q=m_participants.begin(); q!=m_participants.end(); q++) {
+    if(q->second < m_step)
+      return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: postTick()
+//   Purpose: Advance the step counter and publish the new tick,
+//            stamped with the simulated time it ends at. Simulated
+//            time starts at the MOOSTime of the first tick and moves
+//            step_size per step, however long the step took.
+//    Format: "step=12,time=1718052303.750,dt=0.25"
+
+void LockstepClock::postTick()
+{
+  if((m_max_steps > 0) && (m_step >= m_max_steps)) {
+    m_finished = true;
+    Notify("LOCKSTEP_DONE", "true");
+    return;
+  }
+
+  m_step++;
+  m_tick_post_time = MOOSTime();
+  if(m_step == 1) {
+    m_first_tick_time = m_tick_post_time;
+    m_sim_start_time  = m_tick_post_time;
+  }
+
+  // Step 1 only sets the start, so it has no time to advance over
+  double sim_time = m_sim_start_time + (m_step - 1) * m_step_size;
+  double dt = (m_step == 1) ? 0 : m_step_size;
+
+  string tick = "step=" + uintToString(m_step);
+  tick += ",time=" + doubleToString(sim_time, 3);
+  tick += ",dt=" + doubleToString(dt, 3);
+  Notify("LOCKSTEP_TICK", tick);
+}
+
+//------------------------------------------------------------
+// Procedure: buildReport()
+
+bool LockstepClock::buildReport()
+{
+  m_msgs << "============================================" << endl;
+  m_msgs << "File: LockstepClock.cpp                     " << endl;
+  m_msgs << "============================================" << endl;
+
+  double elapsed = m_tick_post_time - m_first_tick_time;
+  double sim_elapsed = 0;
+  if(m_step > 1)
+    sim_elapsed = (m_step - 1) * m_step_size;
+
+  m_msgs << "Step:            " << m_step << (m_finished ? " (finished)" : "") << endl;
+  m_msgs << "Simulated time:  " << doubleToString(sim_elapsed, 2)
+         << " (step_size " << doubleToString(m_step_size, 3) << ")" << endl;
+  m_msgs << "MOOSTime taken:  " << doubleToString(elapsed, 2) << endl;
+  if(elapsed > 0)
+    m_msgs << "Speed-up:        " << doubleToString(sim_elapsed / elapsed, 1) << endl;
+  if(m_step > 1)
+    m_msgs << "Mean step time:  " << doubleToString(elapsed / (m_step-1), 4) << endl;
+  m_msgs << "Acks received:   " << m_total_acks << endl;
+  m_msgs << "Timeouts:        " << m_total_timeouts << endl;
+  m_msgs << "--------------------------------------------" << endl;
+
+  ACTable actab(3);
+  actab << "Participant | Last Acked Step | Waiting";
+  actab.addHeaderLines();
+  map<string, unsigned int>::const_iterator q;
+  for(q=m_participants.begin(); q!=m_participants.end(); q++)
+    actab << q->first << uintToString(q->second) << boolToString(q->second < m_step);
+  m_msgs << actab.getFormattedString();
+
+  return(true);
+}
@@ -0,0 +1,60 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: LockstepClock.h                                 */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#ifndef LockstepClock_HEADER
+#define LockstepClock_HEADER
+
+#include <map>
+#include <string>
+#include "MOOS/libMOOS/Thirdparty/AppCasting/AppCastingMOOSApp.h"
+
+// Drives a simulation in discrete steps of step_size simulated seconds.
+// Each step is posted as LOCKSTEP_TICK, carrying its simulated time and
+// dt, for uSimLockstep to advance the vehicles and pSectorSense to sense
+// at. The next step is posted as soon as every participant has posted a
+// LOCKSTEP_ACK for this one (or ack_timeout expires), so the simulation
+// runs as fast as the apps can turn a step around, and simulated time
+// stands still while a step is outstanding.
+
+class LockstepClock : public AppCastingMOOSApp
+{
+ public:
+   LockstepClock();
+   ~LockstepClock();
+
+ protected: // Standard MOOSApp functions to overload
+   bool OnNewMail(MOOSMSG_LIST &NewMail);
+   bool Iterate();
+   bool OnConnectToServer();
+   bool OnStartUp();
+
+ protected: // Standard AppCastingMOOSApp function to overload
+   bool buildReport();
+
+ protected:
+   void registerVariables();
+   void processAck(CMOOSMsg& msg);
+   bool allAcked() const;
+   void postTick();
+
+ private: // Configuration variables
+   std::map<std::string, unsigned int> m_participants; // vname -> last acked step
+   double       m_step_size;
+   double       m_ack_timeout;
+   unsigned int m_max_steps;
+
+ private: // State variables
+   unsigned int m_step;
+   double       m_sim_start_time;   // Simulated time of step 1
+   double       m_tick_post_time;   // MOOSTime of the latest tick
+   double       m_first_tick_time;  // MOOSTime of step 1
+   unsigned int m_total_timeouts;
+   unsigned int m_total_acks;
+   bool         m_finished;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/****************************************************************/
+/*   NAME: Everardo Gonzalez                                    */
+/*   ORGN: MIT, Cambridge MA                                    */
+/*   FILE: LockstepClock_Info.cpp                               */
+/*   DATE: October 19th, 2026                                   */
+/****************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include "LockstepClock_Info.h"
+#include "ColorParse.h"
+#include "ReleaseInfo.h"
+
+using namespace std;
+
+//----------------------------------------------------------------
+// Procedure: showSynopsis
+
+void showSynopsis()
+{
+  blk("SYNOPSIS:                                                       ");
+  blk("------------------------------------                            ");
+  blk("  The uLockstepClock application runs a simulation in steps of  ");
+  blk("  step_size simulated seconds. Each step is posted as           ");
+  blk("  LOCKSTEP_TICK with its simulated time and dt. uSimLockstep    ");
+  blk("  moves the vehicles over dt and pSectorSense senses at that    ");
+  blk("  time. The next step is posted as soon as every participant    ");
+  blk("  has acknowledged the current one, i.e. has sensed and seen    ");
+  blk("  its controller echo the step in a decision. Simulated time    ");
+  blk("  stands still while a step is outstanding, so the run goes as  ");
+  blk("  fast as the apps can turn steps around, with no TIME_WARP.    ");
+}
+
+//----------------------------------------------------------------
+// Procedure: showHelpAndExit
+
+void showHelpAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("Usage: uLockstepClock file.moos [OPTIONS]                       ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  showSynopsis();
+  blk("                                                                ");
+  blk("Options:                                                        ");
+  mag("  --alias","=<ProcessName>                                      ");
+  blk("      Launch uLockstepClock with the given process name         ");
+  blk("      rather than uLockstepClock.                               ");
+  mag("  --example, -e                                                 ");
+  blk("      Display example MOOS configuration block.                 ");
+  mag("  --help, -h                                                    ");
+  blk("      Display this help message.                                ");
+  mag("  --interface, -i                                               ");
+  blk("      Display MOOS publications and subscriptions.              ");
+  mag("  --version,-v                                                  ");
+  blk("      Display the release version of uLockstepClock.            ");
+  blk("                                                                ");
+  blk("Note: If argv[2] does not otherwise match a known option,       ");
+  blk("      then it will be interpreted as a run alias. This is       ");
+  blk("      to support pAntler launching conventions.                 ");
+  blk("                                                                ");
+  exit(0);
+}
+
+//----------------------------------------------------------------
+// Procedure: showExampleConfigAndExit
+
+void showExampleConfigAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("uLockstepClock Example MOOS Configuration                       ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  blk("ProcessConfig = uLockstepClock                                  ");
+  blk("{                                                               ");
+  blk("  AppTick   = 4                                                 ");
+  blk("  CommsTick = 4                                                 ");
+  blk("                                                                ");
+  blk("  participants = abe,ben      // Vehicles that must ack a step, ");
+  blk("                              // comma or colon separated       ");
+  blk("  step_size    = 0.25         // Simulated secs per step        ");
+  blk("  ack_timeout  = 2.0          // MOOSTime secs before forcing   ");
+  blk("                              // a step, 0 waits forever        ");
+  blk("  max_steps    = 0            // 0 means no limit               ");
+  blk("}                                                               ");
+  blk("                                                                ");
+  blk("On each participating vehicle:                                  ");
+  blk("                                                                ");
+  blk("ProcessConfig = uSimLockstep                                    ");
+  blk("{                                                               ");
+  blk("  start_pos = x=0,y=0,heading=180,speed=0                       ");
+  blk("}                                                               ");
+  blk("                                                                ");
+  blk("ProcessConfig = pSectorSense                                    ");
+  blk("{                                                               ");
+  blk("  lockstep              = true                                  ");
+  blk("  lockstep_tick_var     = LOCKSTEP_SIM_TICK                     ");
+  blk("  lockstep_decision_var = LOCKSTEP_DECISION                     ");
+  blk("}                                                               ");
+  blk("                                                                ");
+  exit(0);
+}
+
+
+//----------------------------------------------------------------
+// Procedure: showInterfaceAndExit
+
+void showInterfaceAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("uLockstepClock INTERFACE                                        ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  showSynopsis();
+  blk("                                                                ");
+  blk("SUBSCRIPTIONS:                                                  ");
+  blk("------------------------------------                            ");
+  blk("  LOCKSTEP_ACK  = vname=abe,step=12                             ");
+  blk("                                                                ");
+  blk("PUBLICATIONS:                                                   ");
+  blk("------------------------------------                            ");
+  blk("  LOCKSTEP_TICK = step=13,time=1718052303.000,dt=0.25           ");
+  blk("  LOCKSTEP_DONE = true    (once max_steps is reached)           ");
+  blk("                                                                ");
+  exit(0);
+}
+
+//----------------------------------------------------------------
+// Procedure: showReleaseInfoAndExit
+
+void showReleaseInfoAndExit()
+{
+  showReleaseInfo("uLockstepClock", "gpl");
+  exit(0);
+}
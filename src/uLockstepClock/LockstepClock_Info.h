@@ -0,0 +1,18 @@
+/****************************************************************/
+/*   NAME: Everardo Gonzalez                                             */
+/*   ORGN: MIT, Cambridge MA                                    */
+/*   FILE: LockstepClock_Info.h                                      */
+/*   DATE: October 19th, 2026                                   */
+/****************************************************************/
+
+#ifndef LockstepClock_INFO_HEADER
+#define LockstepClock_INFO_HEADER
+
+void showSynopsis();
+void showHelpAndExit();
+void showExampleConfigAndExit();
+void showInterfaceAndExit();
+void showReleaseInfoAndExit();
+
+#endif
+
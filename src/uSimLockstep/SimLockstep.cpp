@@ -0,0 +1,383 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: SimLockstep.cpp                                 */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#include <iterator>
+#include <cmath>
+#include "MBUtils.h"
+#include "AngleUtils.h"
+#include "SimLockstep.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// Constructor()
+
+SimLockstep::SimLockstep()
+{
+  m_direct          = false;
+  m_max_speed       = 3;
+  m_max_accel       = 0.5;
+  m_max_turn_rate   = 30;
+  m_thrust_factor   = 20;
+  m_ack             = false;
+  m_tick_echo_var   = "LOCKSTEP_SIM_TICK";
+  m_platform_type   = "kayak";
+  m_platform_color  = "yellow";
+  m_platform_length = 3;
+
+  m_x       = 0;
+  m_y       = 0;
+  m_heading = 0;
+  m_speed   = 0;
+
+  m_desired_heading     = 0;
+  m_desired_speed       = 0;
+  m_desired_rudder      = 0;
+  m_desired_thrust      = 0;
+  m_desired_heading_set = false;
+
+  m_step           = 0;
+  m_sim_time       = 0;
+  m_echo_post_time = 0;
+  m_ack_pending    = false;
+  m_nav_posted     = false;
+  m_total_acks     = 0;
+}
+
+//---------------------------------------------------------
+// Destructor
+
+SimLockstep::~SimLockstep()
+{
+}
+
+//---------------------------------------------------------
+// Procedure: OnNewMail()
+
+bool SimLockstep::OnNewMail(MOOSMSG_LIST &NewMail)
+{
+  AppCastingMOOSApp::OnNewMail(NewMail);
+
+  MOOSMSG_LIST::iterator p;
+  for(p=NewMail.begin(); p!=NewMail.end(); p++) {
+    CMOOSMsg &msg = *p;
+    string key    = msg.GetKey();
+
+    bool command = true;
+    if(key == "DESIRED_HEADING") {
+      m_desired_heading     = msg.GetDouble();
+      m_desired_heading_set = true;
+    }
+    else if(key == "DESIRED_SPEED")
+      m_desired_speed = msg.GetDouble();
+    else if(key == "DESIRED_RUDDER")
+      m_desired_rudder = msg.GetDouble();
+    else if(key == "DESIRED_THRUST")
+      m_desired_thrust = msg.GetDouble();
+    else {
+      command = false;
+      if(key == "LOCKSTEP_TICK")
+        processTick(msg.GetString());
+      else if(key != "APPCAST_REQ") // handled by AppCastingMOOSApp
+        reportRunWarning("Unhandled Mail: " + key);
+    }
+
+    // With no pSectorSense to ack for it, a step is done once the
+    // helm or controller has posted a command after seeing its nav
+    if(command && m_ack_pending && (msg.GetTime() > m_echo_post_time)) {
+      m_ack_pending = false;
+      m_total_acks++;
+      Notify("LOCKSTEP_ACK", "vname=" + m_host_community + ",step=" +
+             uintToString(m_step));
+    }
+  }
+
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: OnConnectToServer()
+
+bool SimLockstep::OnConnectToServer()
+{
+  registerVariables();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: Iterate()
+//            happens AppTick times per second
+
+bool SimLockstep::Iterate()
+{
+  AppCastingMOOSApp::Iterate();
+
+  // The start position goes out once so the helm has nav to begin
+  // with. After that nav only changes with a tick.
+  if(!m_nav_posted) {
+    postNav(MOOSTime());
+    m_nav_posted = true;
+  }
+
+  AppCastingMOOSApp::PostReport();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: OnStartUp()
+//            happens before connection is open
+
+bool SimLockstep::OnStartUp()
+{
+  AppCastingMOOSApp::OnStartUp();
+
+  STRING_LIST sParams;
+  m_MissionReader.EnableVerbatimQuoting(false);
+  if(!m_MissionReader.GetConfiguration(GetAppName(), sParams))
+    reportConfigWarning("No config block found for " + GetAppName());
+
+  STRING_LIST::iterator p;
+  for(p=sParams.begin(); p!=sParams.end(); p++) {
+    string orig  = *p;
+    string line  = *p;
+    string param = tolower(biteStringX(line, '='));
+    string value = line;
+
+    bool handled = false;
+    if(param == "start_pos") {
+      handled = setStartPos(value);
+    }
+    else if(param == "control") {
+      string control = tolower(value);
+      handled = (control == "helm") || (control == "direct");
+      if(handled)
+        m_direct = (control == "direct");
+    }
+    else if(param == "max_speed") {
+      handled = setPosDoubleOnString(m_max_speed, value);
+    }
+    else if(param == "max_acceleration") {
+      handled = setPosDoubleOnString(m_max_accel, value);
+    }
+    else if(param == "max_turn_rate") {
+      handled = setPosDoubleOnString(m_max_turn_rate, value);
+    }
+    else if(param == "thrust_per_speed") {
+      handled = setPosDoubleOnString(m_thrust_factor, value);
+    }
+    else if(param == "ack") {
+      handled = setBooleanOnString(m_ack, value);
+    }
+    else if((param == "tick_echo_var") && (value != "")) {
+      m_tick_echo_var = toupper(value);
+      handled = true;
+    }
+    else if((param == "platform_type") && (value != "")) {
+      m_platform_type = value;
+      handled = true;
+    }
+    else if((param == "platform_color") && (value != "")) {
+      m_platform_color = value;
+      handled = true;
+    }
+    else if(param == "platform_length") {
+      handled = setPosDoubleOnString(m_platform_length, value);
+    }
+
+    if(!handled)
+      reportUnhandledConfigWarning(orig);
+  }
+
+  // Ticks must be stepped when they arrive, not on the next AppTick
+  SetIterateMode(REGULAR_ITERATE_AND_COMMS_DRIVEN_MAIL);
+
+  registerVariables();
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: registerVariables()
+
+void SimLockstep::registerVariables()
+{
+  AppCastingMOOSApp::RegisterVariables();
+  Register("LOCKSTEP_TICK", 0);
+  if(m_direct) {
+    Register("DESIRED_RUDDER", 0);
+    Register("DESIRED_THRUST", 0);
+  }
+  else {
+    Register("DESIRED_HEADING", 0);
+    Register("DESIRED_SPEED", 0);
+  }
+}
+
+//---------------------------------------------------------
+// Procedure: setStartPos()
+//    Format: "x=13.0,y=-20.0,heading=181.0,speed=0"
+//            Fields left out keep their defaults
+
+bool SimLockstep::setStartPos(string str)
+{
+  vector<string> svector = parseString(str, ',');
+  for(unsigned int i=0; i<svector.size(); i++) {
+    string param = tolower(biteStringX(svector[i], '='));
+    string value = svector[i];
+
+    bool ok = false;
+    if(param == "x")
+      ok = setDoubleOnString(m_x, value);
+    else if(param == "y")
+      ok = setDoubleOnString(m_y, value);
+    else if(param == "heading") {
+      ok = setDoubleOnString(m_heading, value);
+      m_heading = angle360(m_heading);
+    }
+    else if(param == "speed")
+      ok = setNonNegDoubleOnString(m_speed, value);
+    if(!ok)
+      return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------
+// Procedure: processTick()
+//   Purpose: Move the vehicle to the tick's time and post where it
+//            is, then echo the tick for pSectorSense. The echo goes
+//            last so the NAV_* reach pSectorSense no later than it.
+//    Format: "step=12,time=1718052303.750,dt=0.25"
+
+void SimLockstep::processTick(const string& tick)
+{
+  int    step = 0;
+  double time = 0;
+  double dt   = 0;
+
+  vector<string> svector = parseString(tick, ',');
+  for(unsigned int i=0; i<svector.size(); i++) {
+    string param = tolower(biteStringX(svector[i], '='));
+    string value = svector[i];
+    if(param == "step")
+      setIntOnString(step, value);
+    else if(param == "time")
+      setDoubleOnString(time, value);
+    else if(param == "dt")
+      setNonNegDoubleOnString(dt, value);
+  }
+
+  // A repeated or stale tick must not move the vehicle twice
+  if((step <= 0) || ((unsigned int)(step) <= m_step))
+    return;
+
+  if(m_ack_pending)
+    reportEvent("Step " + uintToString(m_step) + " stepped past before a command");
+
+  m_step     = step;
+  m_sim_time = time;
+  advance(dt);
+  postNav(time);
+
+  m_echo_post_time = MOOSTime();
+  m_ack_pending    = m_ack;
+  Notify(m_tick_echo_var, tick);
+}
+
+//---------------------------------------------------------
+// Procedure: advance()
+//   Purpose: Integrate the vehicle over dt seconds. Turn rate and
+//            acceleration are capped, and the position moves on the
+//            mean heading and speed over the step.
+
+void SimLockstep::advance(double dt)
+{
+  if(dt <= 0)
+    return;
+
+  double max_turn = m_max_turn_rate * dt;
+  double turn = 0;
+  double target_speed = 0;
+  if(m_direct) {
+    double rudder = vclip(m_desired_rudder, -100, 100);
+    turn = (rudder / 100) * max_turn;
+    target_speed = m_desired_thrust / m_thrust_factor;
+  }
+  else {
+    if(m_desired_heading_set)
+      turn = vclip(angle180(m_desired_heading - m_heading), -max_turn, max_turn);
+    target_speed = m_desired_speed;
+  }
+  target_speed = vclip(target_speed, 0, m_max_speed);
+
+  double max_dv = m_max_accel * dt;
+  double speed  = m_speed + vclip(target_speed - m_speed, -max_dv, max_dv);
+
+  double mean_hdg = degToRadians(m_heading + turn / 2);
+  double mean_spd = (m_speed + speed) / 2;
+  m_x += mean_spd * sin(mean_hdg) * dt;
+  m_y += mean_spd * cos(mean_hdg) * dt;
+
+  m_heading = angle360(m_heading + turn);
+  m_speed   = speed;
+}
+
+//---------------------------------------------------------
+// Procedure: postNav()
+//   Purpose: Post the vehicle's state, with the node report stamped
+//            with the given simulated time so vehicle staleness is
+//            judged on the same clock pSectorSense senses at
+
+void SimLockstep::postNav(double time)
+{
+  Notify("NAV_X", m_x);
+  Notify("NAV_Y", m_y);
+  Notify("NAV_HEADING", m_heading);
+  Notify("NAV_SPEED", m_speed);
+  Notify("NAV_DEPTH", 0.0);
+
+  string report = "NAME=" + m_host_community;
+  report += ",X=" + doubleToString(m_x, 2);
+  report += ",Y=" + doubleToString(m_y, 2);
+  report += ",SPD=" + doubleToString(m_speed, 2);
+  report += ",HDG=" + doubleToString(m_heading, 2);
+  report += ",DEP=0";
+  report += ",TYPE=" + m_platform_type;
+  report += ",COLOR=" + m_platform_color;
+  report += ",LENGTH=" + doubleToStringX(m_platform_length, 2);
+  report += ",TIME=" + doubleToString(time, 3);
+  Notify("NODE_REPORT_LOCAL", report);
+}
+
+//------------------------------------------------------------
+// Procedure: buildReport()
+
+bool SimLockstep::buildReport()
+{
+  m_msgs << "============================================" << endl;
+  m_msgs << "File: SimLockstep.cpp                       " << endl;
+  m_msgs << "============================================" << endl;
+
+  m_msgs << "Control:         " << (m_direct ? "direct" : "helm") << endl;
+  m_msgs << "Step:            " << m_step << endl;
+  m_msgs << "Simulated time:  " << doubleToString(m_sim_time, 3) << endl;
+  if(m_ack)
+    m_msgs << "Acks posted:     " << m_total_acks
+           << (m_ack_pending ? " (awaiting a command)" : "") << endl;
+  m_msgs << "--------------------------------------------" << endl;
+  m_msgs << "X, Y:            " << doubleToString(m_x, 2) << ", "
+         << doubleToString(m_y, 2) << endl;
+  m_msgs << "Heading:         " << doubleToString(m_heading, 1) << endl;
+  m_msgs << "Speed:           " << doubleToString(m_speed, 2) << endl;
+  if(m_direct)
+    m_msgs << "Rudder, thrust:  " << doubleToString(m_desired_rudder, 1)
+           << ", " << doubleToString(m_desired_thrust, 1) << endl;
+  else
+    m_msgs << "Desired hdg/spd: " << doubleToString(m_desired_heading, 1)
+           << ", " << doubleToString(m_desired_speed, 2) << endl;
+
+  return(true);
+}
@@ -0,0 +1,75 @@
+/************************************************************/
+/*    NAME: Everardo Gonzalez                               */
+/*    ORGN: MIT, Cambridge MA                               */
+/*    FILE: SimLockstep.h                                   */
+/*    DATE: October 19th, 2026                              */
+/************************************************************/
+
+#ifndef SimLockstep_HEADER
+#define SimLockstep_HEADER
+
+#include <string>
+#include "MOOS/libMOOS/Thirdparty/AppCasting/AppCastingMOOSApp.h"
+
+// A vehicle simulator stepped by uLockstepClock rather than by MOOSTime.
+// On each LOCKSTEP_TICK it moves the vehicle over the tick's dt on the
+// latest commands, posts NAV_* and NODE_REPORT_LOCAL stamped with the
+// tick's simulated time, then echoes the tick as LOCKSTEP_SIM_TICK so
+// pSectorSense senses the new position. Between ticks the vehicle does
+// not move, however long the helm or controller takes to decide.
+
+class SimLockstep : public AppCastingMOOSApp
+{
+ public:
+   SimLockstep();
+   ~SimLockstep();
+
+ protected: // Standard MOOSApp functions to overload
+   bool OnNewMail(MOOSMSG_LIST &NewMail);
+   bool Iterate();
+   bool OnConnectToServer();
+   bool OnStartUp();
+
+ protected: // Standard AppCastingMOOSApp function to overload
+   bool buildReport();
+
+ protected:
+   void registerVariables();
+   bool setStartPos(std::string str);
+   void processTick(const std::string& tick);
+   void advance(double dt);
+   void postNav(double time);
+
+ private: // Configuration variables
+   bool         m_direct;          // DESIRED_RUDDER/THRUST, not the helm's
+   double       m_max_speed;
+   double       m_max_accel;       // m/s^2
+   double       m_max_turn_rate;   // deg/s, at full rudder if direct
+   double       m_thrust_factor;   // Thrust % per m/s if direct
+   bool         m_ack;             // Ack steps itself, with no pSectorSense
+   std::string  m_tick_echo_var;
+   std::string  m_platform_type;
+   std::string  m_platform_color;
+   double       m_platform_length;
+
+ private: // State variables
+   double       m_x;
+   double       m_y;
+   double       m_heading;
+   double       m_speed;
+
+   double       m_desired_heading;
+   double       m_desired_speed;
+   double       m_desired_rudder;
+   double       m_desired_thrust;
+   bool         m_desired_heading_set;
+
+   unsigned int m_step;
+   double       m_sim_time;
+   double       m_echo_post_time;  // MOOSTime the latest tick was echoed
+   bool         m_ack_pending;
+   bool         m_nav_posted;
+   unsigned int m_total_acks;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/****************************************************************/
+/*   NAME: Everardo Gonzalez                                    */
+/*   ORGN: MIT, Cambridge MA                                    */
+/*   FILE: SimLockstep_Info.cpp                                 */
+/*   DATE: October 19th, 2026                                   */
+/****************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include "SimLockstep_Info.h"
+#include "ColorParse.h"
+#include "ReleaseInfo.h"
+
+using namespace std;
+
+//----------------------------------------------------------------
+// Procedure: showSynopsis
+
+void showSynopsis()
+{
+  blk("SYNOPSIS:                                                       ");
+  blk("------------------------------------                            ");
+  blk("  The uSimLockstep application simulates a vehicle in steps set ");
+  blk("  by uLockstepClock rather than by MOOSTime. On each            ");
+  blk("  LOCKSTEP_TICK it moves the vehicle over the tick's dt on the  ");
+  blk("  latest helm (or direct rudder and thrust) commands, posts     ");
+  blk("  NAV_* and a NODE_REPORT_LOCAL stamped with the tick's time,   ");
+  blk("  then echoes the tick for pSectorSense. The vehicle does not   ");
+  blk("  move between ticks, so results do not depend on how fast the  ");
+  blk("  helm or controller runs. Vehicles without pSectorSense can set");
+  blk("  ack = true to ack a step once a command follows it.           ");
+}
+
+//----------------------------------------------------------------
+// Procedure: showHelpAndExit
+
+void showHelpAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("Usage: uSimLockstep file.moos [OPTIONS]                         ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  showSynopsis();
+  blk("                                                                ");
+  blk("Options:                                                        ");
+  mag("  --alias","=<ProcessName>                                      ");
+  blk("      Launch uSimLockstep with the given process name           ");
+  blk("      rather than uSimLockstep.                                 ");
+  mag("  --example, -e                                                 ");
+  blk("      Display example MOOS configuration block.                 ");
+  mag("  --help, -h                                                    ");
+  blk("      Display this help message.                                ");
+  mag("  --interface, -i                                               ");
+  blk("      Display MOOS publications and subscriptions.              ");
+  mag("  --version,-v                                                  ");
+  blk("      Display the release version of uSimLockstep.              ");
+  blk("                                                                ");
+  blk("Note: If argv[2] does not otherwise match a known option,       ");
+  blk("      then it will be interpreted as a run alias. This is       ");
+  blk("      to support pAntler launching conventions.                 ");
+  blk("                                                                ");
+  exit(0);
+}
+
+//----------------------------------------------------------------
+// Procedure: showExampleConfigAndExit
+
+void showExampleConfigAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("uSimLockstep Example MOOS Configuration                         ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  blk("ProcessConfig = uSimLockstep                                    ");
+  blk("{                                                               ");
+  blk("  AppTick   = 4                                                 ");
+  blk("  CommsTick = 4                                                 ");
+  blk("                                                                ");
+  blk("  start_pos        = x=0,y=-20,heading=180,speed=0              ");
+  blk("  control          = helm  // or direct (DESIRED_RUDDER/THRUST) ");
+  blk("  max_speed        = 3     // m/s                               ");
+  blk("  max_acceleration = 0.5   // m/s^2                             ");
+  blk("  max_turn_rate    = 30    // deg/s, at full rudder if direct   ");
+  blk("  thrust_per_speed = 20    // Thrust % per m/s, if direct       ");
+  blk("  ack              = false // Ack steps with no pSectorSense    ");
+  blk("  tick_echo_var    = LOCKSTEP_SIM_TICK                          ");
+  blk("                                                                ");
+  blk("  platform_type    = kayak                                      ");
+  blk("  platform_color   = yellow                                     ");
+  blk("  platform_length  = 3                                          ");
+  blk("}                                                               ");
+  blk("                                                                ");
+  exit(0);
+}
+
+
+//----------------------------------------------------------------
+// Procedure: showInterfaceAndExit
+
+void showInterfaceAndExit()
+{
+  blk("                                                                ");
+  blu("=============================================================== ");
+  blu("uSimLockstep INTERFACE                                          ");
+  blu("=============================================================== ");
+  blk("                                                                ");
+  showSynopsis();
+  blk("                                                                ");
+  blk("SUBSCRIPTIONS:                                                  ");
+  blk("------------------------------------                            ");
+  blk("  LOCKSTEP_TICK   = step=13,time=1718052303.000,dt=0.25         ");
+  blk("  DESIRED_HEADING = 87.5    (control = helm)                    ");
+  blk("  DESIRED_SPEED   = 1.5     (control = helm)                    ");
+  blk("  DESIRED_RUDDER  = 12.4    (control = direct)                  ");
+  blk("  DESIRED_THRUST  = 30      (control = direct)                  ");
+  blk("                                                                ");
+  blk("PUBLICATIONS:                                                   ");
+  blk("------------------------------------                            ");
+  blk("  NAV_X, NAV_Y, NAV_HEADING, NAV_SPEED, NAV_DEPTH               ");
+  blk("  NODE_REPORT_LOCAL = NAME=abe,X=12.5,Y=-20.1,SPD=1.5,HDG=87.5, ");
+  blk("                      DEP=0,TYPE=kayak,COLOR=yellow,LENGTH=3,   ");
+  blk("                      TIME=1718052303.000                       ");
+  blk("  LOCKSTEP_SIM_TICK = step=13,time=1718052303.000,dt=0.25       ");
+  blk("    The tick, echoed after the NAV_* and NODE_REPORT_LOCAL.     ");
+  blk("  LOCKSTEP_ACK      = vname=abe,step=13    (ack = true only)    ");
+  blk("                                                                ");
+  exit(0);
+}
+
+//----------------------------------------------------------------
+// Procedure: showReleaseInfoAndExit
+
+void showReleaseInfoAndExit()
+{
+  showReleaseInfo("uSimLockstep", "gpl");
+  exit(0);
+}